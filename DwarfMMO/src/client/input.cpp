@@ -3,6 +3,9 @@
 #include "game/world.hpp"
 #include "network/client.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 // Helper to convert screen coordinates to tile coordinates
 void InputHandler::screenToTile(int screenX, int screenY, int& tileX, int& tileY) const {
@@ -108,28 +111,24 @@ bool InputHandler::processInput(Player* player, World* world, NetworkClient* net
                 break;
                 
             case SDL_MOUSEBUTTONDOWN:
-                if (m_placingWalls && world && network && player && event.button.button == SDL_BUTTON_LEFT) {
-                    int tileX, tileY;
-                    screenToTile(m_mouseX, m_mouseY, tileX, tileY);
-                    
-                    // Calculate distance from player
-                    int playerX = player->getX();
-                    int playerY = player->getY();
-                    int dx = tileX - playerX;
-                    int dy = tileY - playerY;
-                    float distance = std::sqrt(dx * dx + dy * dy);
-                    
-                    // Check if within interact range
-                    if (distance <= PLAYER_INTERACT_RANGE) {
-                        // Place a green wall at the clicked location
-                        world->setTile(tileX, tileY, TileType::GREEN_WALL);
-                        
-                        // Send world modification to server
-                        WorldModificationPacket packet(tileX, tileY, static_cast<uint8_t>(TileType::GREEN_WALL));
-                        network->sendPacket(packet);
-                    } else {
-                        std::cout << "Cannot place wall: too far from player (distance: " 
-                                  << distance << " > " << PLAYER_INTERACT_RANGE << ")" << std::endl;
+                if (m_placingWalls && event.button.button == SDL_BUTTON_LEFT) {
+                    // Remember where the drag started; the edit goes out on release
+                    screenToTile(event.button.x, event.button.y, m_dragStartX, m_dragStartY);
+                    m_dragging = true;
+                }
+                break;
+                
+            case SDL_MOUSEBUTTONUP:
+                if (m_dragging && event.button.button == SDL_BUTTON_LEFT) {
+                    m_dragging = false;
+                    if (m_placingWalls && world && network && player) {
+                        int tileX, tileY;
+                        screenToTile(event.button.x, event.button.y, tileX, tileY);
+                        if (tileX == m_dragStartX && tileY == m_dragStartY) {
+                            placeWall(tileX, tileY, player, world, network);
+                        } else {
+                            placeWallRegion(tileX, tileY, SDL_GetModState(), player, world, network);
+                        }
                     }
                 }
                 break;
@@ -168,4 +167,77 @@ bool InputHandler::processInput(Player* player, World* world, NetworkClient* net
 bool InputHandler::isKeyPressed(SDL_Scancode key) const {
     auto it = m_keyStates.find(key);
     return (it != m_keyStates.end() && it->second);
-}
\ No newline at end of file
+}
+
+void InputHandler::placeWall(int tileX, int tileY, Player* player, World* world, NetworkClient* network) {
+    // Calculate distance from player
+    int playerX = player->getX();
+    int playerY = player->getY();
+    int dx = tileX - playerX;
+    int dy = tileY - playerY;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    
+    // Check if within interact range
+    if (distance <= PLAYER_INTERACT_RANGE) {
+        // Place a green wall at the clicked location
+        world->setTile(tileX, tileY, TileType::GREEN_WALL);
+        
+        // Send world modification to server
+        WorldModificationPacket packet(tileX, tileY, static_cast<uint8_t>(TileType::GREEN_WALL));
+        network->sendPacket(packet);
+    } else {
+        std::cout << "Cannot place wall: too far from player (distance: " 
+                  << distance << " > " << PLAYER_INTERACT_RANGE << ")" << std::endl;
+    }
+}
+
+void InputHandler::placeWallRegion(int tileX, int tileY, uint16_t modifiers, Player* player, World* world,
+                                   NetworkClient* network) {
+    // Drag fills a rectangle, Shift+drag draws a line, Ctrl+drag builds the
+    // outline of a room
+    RegionEditPacket packet(RegionShape::RECT, m_dragStartX, m_dragStartY, tileX, tileY,
+                            static_cast<uint8_t>(TileType::GREEN_WALL));
+    if (modifiers & KMOD_SHIFT) {
+        packet = RegionEditPacket(RegionShape::LINE, m_dragStartX, m_dragStartY, tileX, tileY,
+                                  static_cast<uint8_t>(TileType::GREEN_WALL));
+    } else if (modifiers & KMOD_CTRL) {
+        packet = RegionEditPacket(RegionShape::BRUSH, m_dragStartX, m_dragStartY, tileX, tileY,
+                                  static_cast<uint8_t>(TileType::GREEN_WALL));
+        int width = std::abs(tileX - m_dragStartX) + 1;
+        int height = std::abs(tileY - m_dragStartY) + 1;
+        std::vector<uint8_t>& outline = packet.getMask();
+        outline.assign(regionMaskSize(width, height), 0);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (x == 0 || y == 0 || x == width - 1 || y == height - 1) {
+                    size_t index = static_cast<size_t>(y) * width + x;
+                    outline[index >> 3] |= static_cast<uint8_t>(1u << (index & 7));
+                }
+            }
+        }
+    }
+    
+    RegionMask mask;
+    if (!rasterizeRegion(packet.getShape(), packet.getX0(), packet.getY0(), packet.getX1(), packet.getY1(),
+                         packet.getMask().data(), packet.getMask().size(), mask)) {
+        std::cout << "Cannot place walls: region larger than " << MAX_REGION_SIDE << " tiles" << std::endl;
+        return;
+    }
+    
+    // Same reach rule as the server: the nearest tile of the region must be in range
+    int playerX = player->getX();
+    int playerY = player->getY();
+    int dx = std::max({mask.x - playerX, 0, playerX - (mask.x + mask.width - 1)});
+    int dy = std::max({mask.y - playerY, 0, playerY - (mask.y + mask.height - 1)});
+    float distance = std::sqrt(dx * dx + dy * dy);
+    if (distance > PLAYER_INTERACT_RANGE) {
+        std::cout << "Cannot place walls: too far from player (distance: " 
+                  << distance << " > " << PLAYER_INTERACT_RANGE << ")" << std::endl;
+        return;
+    }
+    
+    // Update the local world immediately, then send the whole region at once
+    world->fillRegion(mask.x, mask.y, mask.width, mask.height,
+                      mask.isFull() ? nullptr : mask.bits.data(), TileType::GREEN_WALL);
+    network->sendPacket(packet);
+}
@@ -35,8 +35,20 @@ public:
     void screenToTile(int screenX, int screenY, int& tileX, int& tileY) const;
     
 private:
+    // Place one wall at a clicked tile
+    void placeWall(int tileX, int tileY, Player* player, World* world, NetworkClient* network);
+    
+    // Place walls over the region dragged from the drag start to a tile
+    void placeWallRegion(int tileX, int tileY, uint16_t modifiers, Player* player, World* world,
+                         NetworkClient* network);
+    
     std::unordered_map<SDL_Scancode, bool> m_keyStates;
     bool m_placingWalls = false;
     int m_mouseX = 0;
     int m_mouseY = 0;
+    
+    // Tile where the current wall-placement drag started
+    bool m_dragging = false;
+    int m_dragStartX = 0;
+    int m_dragStartY = 0;
 };
\ No newline at end of file
@@ -28,7 +28,8 @@ void World::render(Renderer* renderer) {
         for (int x = 0; x < m_width; ++x) {
             const Tile& tile = m_tiles[getIndex(x, y)];
             if (tile.type != TileType::EMPTY) {
-                renderer->drawTile(x, y, tile.symbol, tile.color);
+                const TileProperties& properties = tileProperties(tile.type);
+                renderer->drawTile(x, y, properties.symbol, SDL_Color{properties.r, properties.g, properties.b, 255});
             }
         }
     }
@@ -71,6 +72,28 @@ void World::setTile(int x, int y, TileType type) {
     }
 }
 
+void World::fillRegion(int x, int y, int width, int height, const uint8_t* mask, TileType type) {
+    Tile tile(type);
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            size_t index = static_cast<size_t>(row) * width + column;
+            if ((!mask || ((mask[index >> 3] >> (index & 7)) & 1u)) && isInBounds(x + column, y + row)) {
+                m_tiles[getIndex(x + column, y + row)] = tile;
+            }
+        }
+    }
+}
+
+void World::setChunkTiles(int x, int y, int width, int height, const uint8_t* types) {
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            if (isInBounds(x + column, y + row)) {
+                m_tiles[getIndex(x + column, y + row)] = Tile(static_cast<TileType>(types[row * width + column]));
+            }
+        }
+    }
+}
+
 Tile World::getTile(int x, int y) const {
     if (isInBounds(x, y)) {
         return m_tiles[getIndex(x, y)];
@@ -79,7 +102,7 @@ Tile World::getTile(int x, int y) const {
 }
 
 bool World::isSolid(int x, int y) const {
-    return !isInBounds(x, y) || m_tiles[getIndex(x, y)].solid;
+    return !isInBounds(x, y) || m_tiles[getIndex(x, y)].solid();
 }
 
 void World::addEntity(std::shared_ptr<Entity> entity) {
@@ -1,55 +1,16 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <SDL2/SDL.h>
+#include "game/tile.hpp"
 
 // Forward declarations
 class Renderer;
 class Entity;
 
-// Tile type enum
-enum class TileType {
-    EMPTY,
-    FLOOR,
-    WALL,
-    GREEN_WALL
-};
-
-// Tile structure
-struct Tile {
-    TileType type;
-    char symbol;
-    SDL_Color color;
-    bool solid;
-    
-    Tile(TileType t = TileType::EMPTY) : type(t) {
-        switch (t) {
-            case TileType::EMPTY:
-                symbol = ' ';
-                color = {0, 0, 0, 255};
-                solid = false;
-                break;
-            case TileType::FLOOR:
-                symbol = '.';
-                color = {100, 100, 100, 255};
-                solid = false;
-                break;
-            case TileType::WALL:
-                symbol = '#';
-                color = {150, 150, 150, 255};
-                solid = true;
-                break;
-            case TileType::GREEN_WALL:
-                symbol = '#';
-                color = {0, 200, 0, 255};
-                solid = true;
-                break;
-        }
-    }
-};
-
 class World {
 public:
     World(int width = 100, int height = 100);
@@ -60,6 +21,14 @@ public:
     
     // World modification
     void setTile(int x, int y, TileType type);
+    
+    // Set the tiles of a width x height rectangle whose bit is set in mask
+    // (row-major, least significant bit first; null sets all of them)
+    void fillRegion(int x, int y, int width, int height, const uint8_t* mask, TileType type);
+    
+    // Set a width x height rectangle from row-major tile types (a received chunk)
+    void setChunkTiles(int x, int y, int width, int height, const uint8_t* types);
+    
     Tile getTile(int x, int y) const;
     bool isSolid(int x, int y) const;
     
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -15,6 +16,8 @@
 #include "game/player.hpp"
 #include "network/client.hpp"
 #include "network/packet.hpp"
+#include "network/snapshot.hpp"
+#include "network/chunk_codec.hpp"
 
 // Server connection settings
 const std::string SERVER_HOST = "127.0.0.1"; // localhost by default
@@ -134,11 +137,11 @@ int main(int argc, char* argv[]) {
 
         player->setName(playerName);
         
-        // Send connection request
-        ConnectRequestPacket connectPacket(playerName);
+        // Send connection request, asking for compressed chunks
+        ConnectRequestPacket connectPacket(playerName, CAPABILITY_COMPRESSED_CHUNKS);
         network->sendPacket(connectPacket);
 
-        network->setPacketHandler<ConnectAcceptPacket>([&](const ConnectAcceptPacket& packet) {
+        network->setPacketHandler<ConnectAcceptView>([&](const ConnectAcceptView& packet) {
             uint32_t playerId = packet.getPlayerId();
             player->setId(playerId);
             
@@ -153,60 +156,26 @@ int main(int argc, char* argv[]) {
             network->sendPacket(appearanceUpdate);
         });
         
-        network->setPacketHandler<PlayerPositionPacket>([&](const PlayerPositionPacket& packet) {
+        network->setPacketHandler<PlayerPositionView>([&](const PlayerPositionView& packet) {
             uint32_t playerId = packet.getPlayerId();
             if (playerId != player->getId()) {
-                // Update position of other player
+                // Update position of other player. The server spawns a player
+                // before sending its positions, so a late datagram for a
+                // despawned player is dropped
                 auto otherPlayer = world->getEntity(playerId);
-                if (!otherPlayer) {
-                    // Create new player entity with an explicit shared_ptr 
-                    std::shared_ptr<Player> newPlayer = std::make_shared<Player>(packet.getX(), packet.getY());
-                    newPlayer->setId(playerId);
-                    newPlayer->setName("Player " + std::to_string(playerId)); // Default name until we get appearance
-                    newPlayer->setVisible(true); // Ensure visibility is set
-                    
-                    // // Set other players to yellow
-                    // SDL_Color otherColor = {255, 255, 0, 255}; // Yellow
-                    // newPlayer->setColor(otherColor);
-                    
-                    // Insert it into the world
-                    world->addEntity(newPlayer);
-                    
-                    // When we receive a new player, force an appearance packet for our own player
-                    SDL_Color myColor = player->getColor();
-                    PlayerAppearancePacket appearanceUpdate(
-                        player->getId(), 
-                        player->getSymbol(),
-                        myColor.r, myColor.g, myColor.b,
-                        playerName
-                    );
-                    network->sendPacket(appearanceUpdate);
-                    
-                    // Also force a position update to the server for our player
-                    PlayerPositionPacket posUpdate(player->getId(), player->getX(), player->getY());
-                    network->sendPacket(posUpdate);
-                } else {
-                    // Update existing player position
+                if (otherPlayer) {
                     otherPlayer->setPosition(packet.getX(), packet.getY());
-                    otherPlayer->setVisible(true); // Ensure visibility is set
                 }
             }
         });
 
-        network->setPacketHandler<PlayerAppearancePacket>([&](const PlayerAppearancePacket& packet) {
+        network->setPacketHandler<PlayerAppearanceView>([&](const PlayerAppearanceView& packet) {
             uint32_t playerId = packet.getPlayerId();
             if (playerId != player->getId()) {
+                // Appearance changes only arrive for players already spawned
                 auto otherPlayer = world->getEntity(playerId);
                 if (!otherPlayer) {
-                    // Create new player entity
-                    std::shared_ptr<Player> newPlayer = std::make_shared<Player>();
-                    newPlayer->setId(playerId);
-                    newPlayer->setPosition(0, 0); // Default position until we get position update
-                    newPlayer->setVisible(true); // Ensure it's visible!
-                    
-                    // Insert it into the world
-                    world->addEntity(newPlayer);
-                    otherPlayer = newPlayer;
+                    return;
                 }
                 
                 // Set player appearance
@@ -219,37 +188,128 @@ int main(int argc, char* argv[]) {
                 };
 
                 otherPlayer->setColor(color);
-                otherPlayer->setName(packet.getName());
+                otherPlayer->setName(std::string(packet.getName()));
                 otherPlayer->setVisible(true); // Ensure visibility is set
             }
         });
         
-        network->setPacketHandler<PlayerListPacket>([&](const PlayerListPacket& packet) {
-            for (const auto& playerInfo : packet.getPlayers()) {
+        network->setPacketHandler<PlayerListView>([&](const PlayerListView& packet) {
+            packet.forEachPlayer([&](const PlayerListView::PlayerInfo& playerInfo) {
                 uint32_t playerId = playerInfo.id;
                 
                 // Skip our own player
                 if (playerId == player->getId()) {
-                    continue;
+                    return;
                 }
                 auto otherPlayer = world->getEntity(playerId);
                 if (!otherPlayer) {
                     // Create new player entity with an explicit shared_ptr
                     std::shared_ptr<Player> newPlayer = std::make_shared<Player>(playerInfo.x, playerInfo.y);
                     newPlayer->setId(playerId);
-                    newPlayer->setName(playerInfo.name);
+                    newPlayer->setName(std::string(playerInfo.name));
                     newPlayer->setVisible(true); // Ensure visibility is set
                     
                     world->addEntity(newPlayer);
                 } else {
                     otherPlayer->setVisible(true); // Ensure visibility is set
                     otherPlayer->setPosition(playerInfo.x, playerInfo.y);
-                    otherPlayer->setName(playerInfo.name);
+                    otherPlayer->setName(std::string(playerInfo.name));
                 }
+            });
+        });
+        
+        // Snapshots received so far, kept as baselines for the deltas that follow
+        SnapshotHistory snapshots;
+        SnapshotState snapshotState;
+        uint32_t newestSnapshotTick = 0;
+        
+        network->setPacketHandler<EntitySpawnView>([&](const EntitySpawnView& packet) {
+            uint32_t entityId = packet.getEntityId();
+            if (entityId == player->getId()) {
+                return;
+            }
+            
+            // A player came into view: create it, or refresh it if we still have it
+            auto otherPlayer = world->getEntity(entityId);
+            if (!otherPlayer) {
+                std::shared_ptr<Player> newPlayer = std::make_shared<Player>(packet.getX(), packet.getY());
+                newPlayer->setId(entityId);
+                world->addEntity(newPlayer);
+                otherPlayer = newPlayer;
             }
+            
+            // A snapshot sent over UDP can overtake the spawn. Once it has
+            // been acked, later deltas leave the entity out until it moves
+            // again, so its position there wins over the spawn's.
+            int x = packet.getX();
+            int y = packet.getY();
+            auto snapshotEntity = std::lower_bound(snapshotState.begin(), snapshotState.end(), entityId,
+                [](const SnapshotEntity& entity, uint32_t id) { return entity.id < id; });
+            if (snapshotEntity != snapshotState.end() && snapshotEntity->id == entityId) {
+                x = snapshotEntity->x;
+                y = snapshotEntity->y;
+            }
+            
+            SDL_Color color = {
+                packet.getColorR(),
+                packet.getColorG(),
+                packet.getColorB(),
+                255 // Alpha is always 255
+            };
+            otherPlayer->setPosition(x, y);
+            otherPlayer->setSymbol(packet.getSymbol());
+            otherPlayer->setColor(color);
+            otherPlayer->setName(std::string(packet.getName()));
+            otherPlayer->setVisible(true);
         });
         
-        network->setPacketHandler<WorldModificationPacket>([&](const WorldModificationPacket& packet) {
+        network->setPacketHandler<EntityDespawnView>([&](const EntityDespawnView& packet) {
+            // Out of view or disconnected
+            if (packet.getEntityId() != player->getId()) {
+                world->removeEntity(packet.getEntityId());
+            }
+        });
+        
+        network->setPacketHandler<SnapshotView>([&](const SnapshotView& packet) {
+            // Snapshots over UDP can arrive late or twice
+            uint32_t tick = packet.getTick();
+            if (newestSnapshotTick != 0 && !isNewerSequence(tick, newestSnapshotTick)) {
+                return;
+            }
+            
+            static const SnapshotState EMPTY_STATE;
+            const SnapshotState* baseline = &EMPTY_STATE;
+            if (packet.getBaselineTick() != 0) {
+                baseline = snapshots.find(packet.getBaselineTick());
+                if (!baseline) {
+                    std::cerr << "Snapshot " << tick << " references unknown baseline "
+                              << packet.getBaselineTick() << std::endl;
+                    return;
+                }
+            }
+            
+            if (!decodeSnapshotDelta(*baseline, packet.getDeltaData(), packet.getDeltaDataSize(), snapshotState)) {
+                std::cerr << "Malformed snapshot " << tick << std::endl;
+                return;
+            }
+            
+            snapshots.store(tick, snapshotState);
+            newestSnapshotTick = tick;
+            
+            // Players are created by their spawn (which reads this state if
+            // the snapshot got here first); the snapshot only moves them
+            for (const SnapshotEntity& entity : snapshotState) {
+                int entityId = static_cast<int>(entity.id);
+                auto otherPlayer = world->getEntity(entityId);
+                if (otherPlayer && entityId != player->getId()) {
+                    otherPlayer->setPosition(entity.x, entity.y);
+                }
+            }
+            
+            network->sendPacket(SnapshotAckPacket(tick));
+        });
+        
+        network->setPacketHandler<WorldModificationView>([&](const WorldModificationView& packet) {
             // Update local world tile
             TileType tileType = static_cast<TileType>(packet.getTileType());
             world->setTile(packet.getX(), packet.getY(), tileType);
@@ -257,28 +317,51 @@ int main(int argc, char* argv[]) {
                       << ") to tile type " << static_cast<int>(tileType) << std::endl;
         });
         
-        network->setPacketHandler<WorldChunkPacket>([&](const WorldChunkPacket& packet) {
-            int chunkX = packet.getX();
-            int chunkY = packet.getY();
-            int width = packet.getWidth();
-            int height = packet.getHeight();
-            
-            const auto& tileData = packet.getTileData();
-            size_t index = 0;
-            
-            for (int y = 0; y < height; ++y) {
-                for (int x = 0; x < width; ++x) {
-                    if (index < tileData.size()) {
-                        TileType type = static_cast<TileType>(tileData[index++]);
-                        world->setTile(chunkX + x, chunkY + y, type);
-                    }
-                }
+        network->setPacketHandler<WorldChunkView>([&](const WorldChunkView& packet) {
+            // Raw tiles, one byte each; a short packet leaves the rest as it was
+            size_t tileCount = static_cast<size_t>(packet.getWidth()) * packet.getHeight();
+            if (packet.getWidth() > 0 && packet.getHeight() > 0 && packet.getTileDataSize() >= tileCount) {
+                world->setChunkTiles(packet.getX(), packet.getY(), packet.getWidth(), packet.getHeight(),
+                                     packet.getTileData());
             }
         });
+        
+        std::vector<uint8_t> chunkTiles;
+        network->setPacketHandler<CompressedChunkView>([&](const CompressedChunkView& packet) {
+            size_t tileCount = static_cast<size_t>(packet.getWidth()) * packet.getHeight();
+            chunkTiles.resize(tileCount);
+            if (!decodeChunkTiles(packet.getEncodedTiles(), packet.getEncodedTilesSize(), chunkTiles.data(), tileCount)) {
+                std::cerr << "Malformed compressed chunk at (" << packet.getX() << "," << packet.getY() << ")" << std::endl;
+                return;
+            }
+            world->setChunkTiles(packet.getX(), packet.getY(), packet.getWidth(), packet.getHeight(), chunkTiles.data());
+        });
+
+        network->setPacketHandler<ChunkDeltaView>([&](const ChunkDeltaView& packet) {
+            // Tiles edited on the server during one tick, newest value per tile
+            packet.forEachChange([&](int x, int y, uint8_t tileType) {
+                world->setTile(x, y, static_cast<TileType>(tileType));
+            });
+        });
 
-        network->setPacketHandler<DisconnectPacket>([&](const DisconnectPacket& packet) {
+        network->setPacketHandler<RegionUpdateView>([&](const RegionUpdateView& packet) {
+            // A whole region edit in one update
+            world->fillRegion(packet.getX(), packet.getY(), packet.getWidth(), packet.getHeight(),
+                              packet.getMask(), static_cast<TileType>(packet.getTileType()));
+        });
+
+        network->setPacketHandler<ChunkUnloadView>([&](const ChunkUnloadView& packet) {
+            // Out of range: forget the tiles until the chunk is streamed again
+            for (int y = 0; y < packet.getHeight(); ++y) {
+                for (int x = 0; x < packet.getWidth(); ++x) {
+                    world->setTile(packet.getX() + x, packet.getY() + y, TileType::EMPTY);
+                }
+            }
+        });
+        
+        network->setPacketHandler<DisconnectView>([&](const DisconnectView& packet) {
             // Get the reason for disconnection
-            std::string reason = packet.getReason();
+            std::string reason(packet.getReason());
             
             // Check if this is a server shutdown message or unexpected disconnect
             if (reason == "Server shutting down" || reason == "Server disconnected unexpectedly") {
@@ -290,21 +373,7 @@ int main(int argc, char* argv[]) {
                 return;
             }
             
-            // Otherwise, this is another player disconnecting
-            // The server sends player name in the reason field when a player disconnects
-            std::string playerName = reason;
-            
-            // Iterate through entities to find and remove the disconnected player
-            for (auto it = world->getEntities().begin(); it != world->getEntities().end(); ) {
-                auto entity = it->second;
-                if (entity->getName() == playerName) {
-                    std::cout << "Player disconnected: " << playerName << std::endl;
-                    world->removeEntity(entity->getId());
-                    break;
-                } else {
-                    ++it;
-                }
-            }
+            std::cout << "Disconnected: " << reason << std::endl;
         });
 
         // Before the game loop, add a signal handler or similar cleanup function
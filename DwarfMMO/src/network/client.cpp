@@ -4,8 +4,13 @@
 NetworkClient::NetworkClient()
     : m_socket(m_ioContext),
       m_connected(false),
-      m_receiveBuffer(1024),
-      m_expectedLength(0) {
+      m_udpSocket(m_ioContext),
+      m_udpHelloTimer(m_ioContext),
+      m_udpToken(0),
+      m_udpHelloAttempts(0),
+      m_udpReady(false),
+      m_udpSendSequence(1),
+      m_lastDatagramTime(std::chrono::steady_clock::time_point()) {
     
     // Start io_context in a separate thread
     m_work = std::make_unique<boost::asio::io_context::work>(m_ioContext);
@@ -63,6 +68,7 @@ void NetworkClient::disconnect() {
         std::cerr << "Disconnect error: " << e.what() << std::endl;
     }
     
+    closeUdp();
     m_connected = false;
 }
 
@@ -75,6 +81,12 @@ void NetworkClient::sendPacket(const Packet& packet) {
         return;
     }
     
+    // Positions go unreliably once the side channel is up
+    if (packet.getType() == PacketType::PLAYER_POSITION && m_udpReady.load() && checkUdpChannel()) {
+        sendDatagram(packet, m_udpSendSequence++);
+        return;
+    }
+    
     try {
         // Serialize packet
         std::vector<uint8_t> buffer;
@@ -102,22 +114,72 @@ void NetworkClient::sendPacket(const Packet& packet) {
     }
 }
 
+template<typename View>
+void NetworkClient::dispatchView(const uint8_t* data, size_t size) {
+    auto& handler = std::get<std::function<void(const View&)>>(m_packetHandlers);
+    if (!handler) {
+        std::cout << "No handler registered for packet type: " << static_cast<int>(View::TYPE) << std::endl;
+        return;
+    }
+    
+    View view;
+    if (!view.bind(data, size)) {
+        std::cout << "Failed to decode packet of type: " << static_cast<int>(View::TYPE) << std::endl;
+        return;
+    }
+    
+    handler(view);
+}
+
+constexpr NetworkClient::PacketDecoderTable NetworkClient::makePacketDecoders() {
+    PacketDecoderTable decoders{};
+    decoders[static_cast<size_t>(PacketType::CONNECT_REQUEST)] = &NetworkClient::dispatchView<ConnectRequestView>;
+    decoders[static_cast<size_t>(PacketType::CONNECT_ACCEPT)] = &NetworkClient::dispatchView<ConnectAcceptView>;
+    decoders[static_cast<size_t>(PacketType::DISCONNECT)] = &NetworkClient::dispatchView<DisconnectView>;
+    decoders[static_cast<size_t>(PacketType::PING)] = &NetworkClient::dispatchView<PingView>;
+    decoders[static_cast<size_t>(PacketType::PONG)] = &NetworkClient::dispatchView<PongView>;
+    decoders[static_cast<size_t>(PacketType::PLAYER_POSITION)] = &NetworkClient::dispatchView<PlayerPositionView>;
+    decoders[static_cast<size_t>(PacketType::PLAYER_APPEARANCE)] = &NetworkClient::dispatchView<PlayerAppearanceView>;
+    decoders[static_cast<size_t>(PacketType::WORLD_CHUNK)] = &NetworkClient::dispatchView<WorldChunkView>;
+    decoders[static_cast<size_t>(PacketType::WORLD_MODIFICATION)] = &NetworkClient::dispatchView<WorldModificationView>;
+    decoders[static_cast<size_t>(PacketType::CHAT_MESSAGE)] = &NetworkClient::dispatchView<ChatMessageView>;
+    decoders[static_cast<size_t>(PacketType::PLAYER_LIST)] = &NetworkClient::dispatchView<PlayerListView>;
+    decoders[static_cast<size_t>(PacketType::ENTITY_SPAWN)] = &NetworkClient::dispatchView<EntitySpawnView>;
+    decoders[static_cast<size_t>(PacketType::ENTITY_DESPAWN)] = &NetworkClient::dispatchView<EntityDespawnView>;
+    decoders[static_cast<size_t>(PacketType::SNAPSHOT)] = &NetworkClient::dispatchView<SnapshotView>;
+    decoders[static_cast<size_t>(PacketType::CHUNK_UNLOAD)] = &NetworkClient::dispatchView<ChunkUnloadView>;
+    decoders[static_cast<size_t>(PacketType::CHUNK_DELTA)] = &NetworkClient::dispatchView<ChunkDeltaView>;
+    decoders[static_cast<size_t>(PacketType::REGION_UPDATE)] = &NetworkClient::dispatchView<RegionUpdateView>;
+    decoders[static_cast<size_t>(PacketType::COMPRESSED_CHUNK)] = &NetworkClient::dispatchView<CompressedChunkView>;
+    return decoders;
+}
+
 void NetworkClient::update() {
-    std::lock_guard<std::mutex> lock(m_packetQueueMutex);
+    static constexpr PacketDecoderTable decoders = makePacketDecoders();
+    
+    // Take everything received so far
+    {
+        std::lock_guard<std::mutex> lock(m_packetQueueMutex);
+        m_dispatchBuffer.swap(m_packetQueue);
+    }
     
-    while (!m_packetQueue.empty()) {
-        auto& packet = m_packetQueue.front();
+    size_t offset = 0;
+    while (offset + 4 <= m_dispatchBuffer.size()) {
+        uint32_t length = codec::load<uint32_t>(m_dispatchBuffer.data() + offset);
+        const uint8_t* data = m_dispatchBuffer.data() + offset + 4;
+        offset += 4 + length;
         
         // Call packet handler if registered
-        auto handlerIt = m_packetHandlers.find(static_cast<uint8_t>(packet->getType()));
-        if (handlerIt != m_packetHandlers.end()) {
-            handlerIt->second(*packet);
+        uint8_t type = data[0];
+        PacketDecoder decoder = type < decoders.size() ? decoders[type] : nullptr;
+        if (decoder) {
+            (this->*decoder)(data, length);
         } else {
-            std::cout << "No handler registered for packet type: " << static_cast<int>(packet->getType()) << std::endl;
+            std::cout << "No handler registered for packet type: " << static_cast<int>(type) << std::endl;
         }
-        
-        m_packetQueue.pop();
     }
+    
+    m_dispatchBuffer.clear();
 }
 
 void NetworkClient::startReceive() {
@@ -125,117 +187,222 @@ void NetworkClient::startReceive() {
         return;
     }
     
-    // Read packet length header (4 bytes)
-    boost::asio::async_read(
-        m_socket,
-        boost::asio::buffer(m_receiveBuffer.data(), 4),
+    // Read whatever is available into the ring
+    m_receiveBuffer.prepare();
+    m_socket.async_read_some(
+        boost::asio::buffer(m_receiveBuffer.writePtr(), m_receiveBuffer.writable()),
         [this](const boost::system::error_code& error, size_t bytesTransferred) {
-            handleReceiveHeader(error, bytesTransferred);
+            handleReceive(error, bytesTransferred);
         }
     );
 }
 
-void NetworkClient::handleReceiveHeader(const boost::system::error_code& error, size_t bytesTransferred) {
+void NetworkClient::handleReceive(const boost::system::error_code& error, size_t bytesTransferred) {
     if (error) {
-        // Only log if it's not just a clean disconnect
-        if (error != boost::asio::error::operation_aborted && 
-            error != boost::asio::error::connection_reset &&
-            error != boost::asio::error::eof) {
-            std::cerr << "Receive header error: " << error.message() << std::endl;
+        handleReceiveError(error);
+        return;
+    }
+    
+    m_receiveBuffer.commit(bytesTransferred);
+    
+    // Process every complete packet in this batch
+    const uint8_t* data = nullptr;
+    uint32_t length = 0;
+    ReceiveBuffer::FrameStatus status;
+    while ((status = m_receiveBuffer.nextFrame(data, length)) == ReceiveBuffer::FrameStatus::COMPLETE) {
+        // The UDP offer is handled by the network layer itself
+        if (static_cast<PacketType>(data[0]) == PacketType::UDP_OFFER) {
+            handleUdpOffer(data, length);
         } else {
-            std::cout << "Server disconnected: " << error.message() << std::endl;
+            processPacket(data, length);
         }
+    }
+    
+    if (status == ReceiveBuffer::FrameStatus::INVALID) {
+        std::cerr << "Invalid packet size received from server" << std::endl;
+        handleReceiveError(boost::asio::error::invalid_argument);
+        return;
+    }
+    
+    // Start receiving more data
+    startReceive();
+}
+
+void NetworkClient::handleReceiveError(const boost::system::error_code& error) {
+    // Only log if it's not just a clean disconnect
+    if (error != boost::asio::error::operation_aborted && 
+        error != boost::asio::error::connection_reset &&
+        error != boost::asio::error::eof) {
+        std::cerr << "Receive error: " << error.message() << std::endl;
+    } else {
+        std::cout << "Server disconnected: " << error.message() << std::endl;
+    }
+    
+    // Notify about disconnection
+    bool wasConnected = m_connected;
+    disconnect();
+    
+    if (wasConnected) {
+        std::cout << "Connection to server lost." << std::endl;
         
-        // Notify about disconnection
-        bool wasConnected = m_connected;
-        disconnect();
-        
-        if (wasConnected) {
-            std::cout << "Connection to server lost." << std::endl;
-            
-            // Queue a "Server disconnected" notification packet
-            try {
-                auto disconnectPacket = std::make_unique<DisconnectPacket>("Server disconnected unexpectedly");
-                std::lock_guard<std::mutex> lock(m_packetQueueMutex);
-                m_packetQueue.push(std::move(disconnectPacket));
-            } catch (const std::exception& e) {
-                std::cerr << "Error creating disconnect notification: " << e.what() << std::endl;
-            }
+        // Queue a "Server disconnected" notification packet
+        try {
+            std::vector<uint8_t> disconnectPacket;
+            DisconnectPacket("Server disconnected unexpectedly").serialize(disconnectPacket);
+            processPacket(disconnectPacket.data(), disconnectPacket.size());
+        } catch (const std::exception& e) {
+            std::cerr << "Error creating disconnect notification: " << e.what() << std::endl;
         }
-        
+    }
+}
+
+void NetworkClient::processPacket(const uint8_t* data, size_t size) {
+    // Copy the frame out of the receive ring; it is decoded on the game thread
+    std::lock_guard<std::mutex> lock(m_packetQueueMutex);
+    uint8_t header[4] = {
+        static_cast<uint8_t>((size >> 24) & 0xFF),
+        static_cast<uint8_t>((size >> 16) & 0xFF),
+        static_cast<uint8_t>((size >> 8) & 0xFF),
+        static_cast<uint8_t>(size & 0xFF)
+    };
+    m_packetQueue.insert(m_packetQueue.end(), header, header + 4);
+    m_packetQueue.insert(m_packetQueue.end(), data, data + size);
+}
+
+void NetworkClient::handleUdpOffer(const uint8_t* data, size_t size) {
+    UdpOfferView offer;
+    if (!offer.bind(data, size) || m_udpSocket.is_open()) {
+        return;
+    }
+    
+    try {
+        // The side channel goes to the same host as the TCP connection
+        udp::endpoint server(m_socket.remote_endpoint().address(), offer.getPort());
+        m_udpSocket.open(server.protocol());
+        m_udpSocket.connect(server);
+    } catch (const std::exception& e) {
+        std::cerr << "UDP side channel unavailable: " << e.what() << std::endl;
+        closeUdp();
         return;
     }
     
-    // Parse packet length
-    m_expectedLength = 
-        (static_cast<uint32_t>(m_receiveBuffer[0]) << 24) |
-        (static_cast<uint32_t>(m_receiveBuffer[1]) << 16) |
-        (static_cast<uint32_t>(m_receiveBuffer[2]) << 8) |
-         static_cast<uint32_t>(m_receiveBuffer[3]);
+    m_udpToken = offer.getToken();
+    m_udpHelloAttempts = 0;
+    startUdpReceive();
+    sendUdpHello();
+}
+
+void NetworkClient::sendUdpHello() {
+    // Give up quietly if UDP is blocked; everything keeps working over TCP
+    static constexpr int MAX_HELLO_ATTEMPTS = 10;
     
-    // Resize buffer if needed
-    if (m_receiveBuffer.size() < m_expectedLength) {
-        m_receiveBuffer.resize(m_expectedLength);
+    if (m_udpReady.load() || !m_udpSocket.is_open() || m_udpHelloAttempts++ >= MAX_HELLO_ATTEMPTS) {
+        return;
     }
     
-    // Read packet body
-    boost::asio::async_read(
-        m_socket,
-        boost::asio::buffer(m_receiveBuffer.data(), m_expectedLength),
+    std::vector<uint8_t> hello;
+    UdpHelloPacket(m_udpToken).serialize(hello);
+    boost::system::error_code ec;
+    m_udpSocket.send(boost::asio::buffer(makeDatagram(0, hello.data(), hello.size())), 0, ec);
+    
+    m_udpHelloTimer.expires_after(std::chrono::milliseconds(250));
+    m_udpHelloTimer.async_wait([this](const boost::system::error_code& error) {
+        if (!error) {
+            sendUdpHello();
+        }
+    });
+}
+
+void NetworkClient::startUdpReceive() {
+    if (!m_udpSocket.is_open()) {
+        return;
+    }
+    
+    m_udpSocket.async_receive(
+        boost::asio::buffer(m_udpReceiveBuffer),
         [this](const boost::system::error_code& error, size_t bytesTransferred) {
-            handleReceiveBody(error, bytesTransferred);
+            handleUdpReceive(error, bytesTransferred);
         }
     );
 }
 
-void NetworkClient::handleReceiveBody(const boost::system::error_code& error, size_t bytesTransferred) {
-    if (error) {
-        // Only log if it's not just a clean disconnect
-        if (error != boost::asio::error::operation_aborted && 
-            error != boost::asio::error::connection_reset &&
-            error != boost::asio::error::eof) {
-            std::cerr << "Receive body error: " << error.message() << std::endl;
-        } else {
-            std::cout << "Server disconnected: " << error.message() << std::endl;
-        }
+void NetworkClient::handleUdpReceive(const boost::system::error_code& error, size_t bytesTransferred) {
+    if (error == boost::asio::error::operation_aborted) {
+        return;
+    }
+    
+    if (!error && bytesTransferred > DATAGRAM_HEADER_SIZE) {
+        m_lastDatagramTime.store(std::chrono::steady_clock::now());
         
-        // Notify about disconnection
-        bool wasConnected = m_connected;
-        disconnect();
+        // The datagram sequence isn't needed: snapshots are ordered by tick
+        const uint8_t* packet = m_udpReceiveBuffer.data() + DATAGRAM_HEADER_SIZE;
+        size_t packetSize = bytesTransferred - DATAGRAM_HEADER_SIZE;
         
-        if (wasConnected) {
-            std::cout << "Connection to server lost during packet receive." << std::endl;
-            
-            // Queue a "Server disconnected" notification packet
-            try {
-                auto disconnectPacket = std::make_unique<DisconnectPacket>("Server disconnected unexpectedly");
-                std::lock_guard<std::mutex> lock(m_packetQueueMutex);
-                m_packetQueue.push(std::move(disconnectPacket));
-            } catch (const std::exception& e) {
-                std::cerr << "Error creating disconnect notification: " << e.what() << std::endl;
+        SnapshotView snapshot;
+        UdpHelloView hello;
+        if (hello.bind(packet, packetSize) && hello.getToken() == m_udpToken) {
+            // Server echoed our hello: the channel works both ways (probes
+            // are echoed too and just count as a datagram heard)
+            if (!m_udpReady.exchange(true)) {
+                m_udpHelloTimer.cancel();
+                std::cout << "UDP side channel ready" << std::endl;
             }
+        } else if (snapshot.bind(packet, packetSize)) {
+            // Snapshots carry their own tick; stale ones are dropped when applied
+            processPacket(packet, packetSize);
         }
-        
-        return;
     }
     
-    // Process received packet
-    processPacket(m_receiveBuffer.data(), bytesTransferred);
+    startUdpReceive();
+}
+
+bool NetworkClient::checkUdpChannel() {
+    // Positions only get through if datagrams from the server still reach
+    // us. After a quiet spell (no snapshots, or a NAT rebinding) a hello asks
+    // the server to echo; if none of those is answered in time, positions
+    // go back to TCP. The server echoes hellos only from the endpoint that
+    // first bound the token, so a rebound client ends up here too.
+    static constexpr auto QUIET_AFTER = std::chrono::milliseconds(1000);
+    static constexpr auto PROBE_INTERVAL = std::chrono::milliseconds(250);
+    static constexpr auto PROBE_TIMEOUT = std::chrono::milliseconds(2000);
     
-    // Start receiving next packet
-    startReceive();
+    auto now = std::chrono::steady_clock::now();
+    auto lastHeard = m_lastDatagramTime.load();
+    if (now - lastHeard < QUIET_AFTER) {
+        return true;
+    }
+    
+    if (m_udpProbeStart <= lastHeard) {
+        m_udpProbeStart = now;
+    } else if (now - m_udpProbeStart > PROBE_TIMEOUT) {
+        m_udpReady = false;
+        std::cout << "UDP side channel stopped answering; positions go over TCP" << std::endl;
+        return false;
+    }
+    
+    if (now - m_udpProbeLast >= PROBE_INTERVAL) {
+        sendDatagram(UdpHelloPacket(m_udpToken), 0);
+        m_udpProbeLast = now;
+    }
+    return true;
 }
 
-void NetworkClient::processPacket(const uint8_t* data, size_t size) {
+void NetworkClient::sendDatagram(const Packet& packet, uint32_t sequence) {
+    std::vector<uint8_t> bytes;
+    packet.serialize(bytes);
     
-    // Create packet from raw data
-    auto packet = Packet::createFromRawData(data, size);
+    boost::system::error_code ec;
+    m_udpSocket.send(boost::asio::buffer(makeDatagram(sequence, bytes.data(), bytes.size())), 0, ec);
     
-    if (packet) {
-        // Add packet to queue
-        std::lock_guard<std::mutex> lock(m_packetQueueMutex);
-        m_packetQueue.push(std::move(packet));
-    } else {
-        std::cout << "Failed to create packet from received data" << std::endl;
+    // A lost datagram is superseded by the next position, so errors are ignored
+}
+
+void NetworkClient::closeUdp() {
+    m_udpReady = false;
+    
+    boost::system::error_code ec;
+    m_udpHelloTimer.cancel();
+    if (m_udpSocket.is_open()) {
+        m_udpSocket.close(ec);
     }
-}
\ No newline at end of file
+}
@@ -2,14 +2,21 @@
 
 #include <string>
 #include <vector>
-#include <queue>
+#include <array>
+#include <tuple>
 #include <memory>
 #include <boost/asio.hpp>
 #include <functional>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
 #include "network/packet.hpp"
+#include "network/receive_buffer.hpp"
+#include "network/datagram.hpp"
 
 using boost::asio::ip::tcp;
+using boost::asio::ip::udp;
 
 class NetworkClient {
 public:
@@ -31,13 +38,11 @@ public:
     // Process received packets
     void update();
     
-    // Set packet handler callback
-    template<typename T>
-    void setPacketHandler(std::function<void(const T&)> handler) {
-        static_assert(std::is_base_of<Packet, T>::value, "T must derive from Packet");
-        m_packetHandlers[static_cast<uint8_t>(T().getType())] = [handler](const Packet& packet) {
-            handler(static_cast<const T&>(packet));
-        };
+    // Set packet handler callback for a packet view type
+    template<typename View>
+    void setPacketHandler(std::function<void(const View&)> handler) {
+        static_assert(std::is_base_of<PacketView, View>::value, "View must derive from PacketView");
+        std::get<std::function<void(const View&)>>(m_packetHandlers) = std::move(handler);
     }
     
 private:
@@ -48,24 +53,91 @@ private:
     std::thread m_networkThread;
     bool m_connected;
     
-    // Receive buffer
-    std::vector<uint8_t> m_receiveBuffer;
-    uint32_t m_expectedLength;
+    // Receive ring, filled by async_read_some
+    ReceiveBuffer m_receiveBuffer;
     
-    // Packet handling
+    // UDP side channel, opened when the server offers one. Positions switch
+    // to it once the server has echoed our hello; until then, and again once
+    // the channel stops answering, they use TCP.
+    udp::socket m_udpSocket;
+    boost::asio::steady_timer m_udpHelloTimer;
+    std::array<uint8_t, MAX_DATAGRAM_SIZE> m_udpReceiveBuffer;
+    uint32_t m_udpToken;
+    int m_udpHelloAttempts;
+    std::atomic<bool> m_udpReady;
+    uint32_t m_udpSendSequence;
+    // When a datagram last arrived from the server (set on the network thread)
+    std::atomic<std::chrono::steady_clock::time_point> m_lastDatagramTime;
+    // First and latest hello sent since then to check the channel (game thread)
+    std::chrono::steady_clock::time_point m_udpProbeStart;
+    std::chrono::steady_clock::time_point m_udpProbeLast;
+    
+    // Received frames ([4-byte length][packet bytes]...) waiting for update().
+    // The two buffers are swapped, so steady-state traffic doesn't allocate.
     std::mutex m_packetQueueMutex;
-    std::queue<std::unique_ptr<Packet>> m_packetQueue;
-    std::unordered_map<uint8_t, std::function<void(const Packet&)>> m_packetHandlers;
+    std::vector<uint8_t> m_packetQueue;
+    std::vector<uint8_t> m_dispatchBuffer;
+    
+    // One typed handler slot per packet view
+    std::tuple<
+        std::function<void(const ConnectRequestView&)>,
+        std::function<void(const ConnectAcceptView&)>,
+        std::function<void(const DisconnectView&)>,
+        std::function<void(const PingView&)>,
+        std::function<void(const PongView&)>,
+        std::function<void(const PlayerPositionView&)>,
+        std::function<void(const PlayerAppearanceView&)>,
+        std::function<void(const WorldChunkView&)>,
+        std::function<void(const WorldModificationView&)>,
+        std::function<void(const ChatMessageView&)>,
+        std::function<void(const PlayerListView&)>,
+        std::function<void(const EntitySpawnView&)>,
+        std::function<void(const EntityDespawnView&)>,
+        std::function<void(const SnapshotView&)>,
+        std::function<void(const ChunkUnloadView&)>,
+        std::function<void(const ChunkDeltaView&)>,
+        std::function<void(const RegionUpdateView&)>,
+        std::function<void(const CompressedChunkView&)>
+    > m_packetHandlers;
+    
+    // Dispatch table indexed by PacketType
+    using PacketDecoder = void (NetworkClient::*)(const uint8_t* data, size_t size);
+    using PacketDecoderTable = std::array<PacketDecoder, PACKET_TYPE_COUNT>;
+    static constexpr PacketDecoderTable makePacketDecoders();
+    
+    // Bind a view over the packet bytes and pass it to the registered handler
+    template<typename View>
+    void dispatchView(const uint8_t* data, size_t size);
     
     // Start receiving data
     void startReceive();
     
-    // Handle received header
-    void handleReceiveHeader(const boost::system::error_code& error, size_t bytesTransferred);
+    // Handle received bytes, processing every complete frame
+    void handleReceive(const boost::system::error_code& error, size_t bytesTransferred);
     
-    // Handle received data
-    void handleReceiveBody(const boost::system::error_code& error, size_t bytesTransferred);
+    // Tear down after a receive error and notify the game
+    void handleReceiveError(const boost::system::error_code& error);
     
-    // Process a single received packet
+    // Queue a single received packet for update()
     void processPacket(const uint8_t* data, size_t size);
+    
+    // Open the UDP side channel the server offered (network thread)
+    void handleUdpOffer(const uint8_t* data, size_t size);
+    
+    // Send the hello datagram, retrying until the server echoes it
+    void sendUdpHello();
+    
+    // Receive datagrams from the server
+    void startUdpReceive();
+    void handleUdpReceive(const boost::system::error_code& error, size_t bytesTransferred);
+    
+    // Whether positions should still go over UDP; probes a quiet channel
+    // with hellos and gives it up if they go unanswered (game thread)
+    bool checkUdpChannel();
+    
+    // Send packet bytes as a datagram (positions, and hellos as probes)
+    void sendDatagram(const Packet& packet, uint32_t sequence);
+    
+    // Close the UDP side channel
+    void closeUdp();
 };
\ No newline at end of file
@@ -5,6 +5,16 @@ Entity::Entity(int x, int y, char symbol)
     : m_x(x), m_y(y), m_symbol(symbol) {
 }
 
+void Entity::setPosition(int x, int y) {
+    m_x = x;
+    m_y = y;
+    
+    // Keep the world's spatial index in step
+    if (m_world) {
+        m_world->updateEntityPosition(m_id, x, y);
+    }
+}
+
 void Entity::update(float deltaTime, World* world) {
     // Base entity doesn't do anything in update
 }
@@ -12,8 +22,7 @@ void Entity::update(float deltaTime, World* world) {
 bool Entity::move(int dx, int dy, World* world) {
     if (!world) {
         // If no world is provided, just move without collision
-        m_x += dx;
-        m_y += dy;
+        setPosition(m_x + dx, m_y + dy);
         return true;
     }
     
@@ -22,8 +31,7 @@ bool Entity::move(int dx, int dy, World* world) {
     int newY = m_y + dy;
     
     if (!world->isSolid(newX, newY)) {
-        m_x = newX;
-        m_y = newY;
+        setPosition(newX, newY);
         return true;
     }
     
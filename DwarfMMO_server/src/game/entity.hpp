@@ -1,11 +1,19 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
-#include <SDL2/SDL.h>
 
 // Forward declarations
 class World;
 
+// Entity colour as sent in appearance packets
+struct Color {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
 class Entity {
 public:
     Entity(int x = 0, int y = 0, char symbol = '?');
@@ -20,7 +28,7 @@ public:
     // Getters and setters
     int getX() const { return m_x; }
     int getY() const { return m_y; }
-    void setPosition(int x, int y) { m_x = x; m_y = y; }
+    void setPosition(int x, int y);
     
     int getId() const { return m_id; }
     void setId(int id) { m_id = id; }
@@ -28,17 +36,21 @@ public:
     char getSymbol() const { return m_symbol; }
     void setSymbol(char symbol) { m_symbol = symbol; }
     
-    const SDL_Color& getColor() const { return m_color; }
-    void setColor(const SDL_Color& color) { m_color = color; }
+    const Color& getColor() const { return m_color; }
+    void setColor(const Color& color) { m_color = color; }
     
     const std::string& getName() const { return m_name; }
     void setName(const std::string& name) { m_name = name; }
     
+    // World whose spatial index tracks this entity (set by World::addEntity)
+    void setWorld(World* world) { m_world = world; }
+    
 protected:
+    World* m_world = nullptr;
     int m_id = 0;
     int m_x = 0;
     int m_y = 0;
     char m_symbol = '?';
-    SDL_Color m_color = {255, 255, 255, 255}; // Default: white
+    Color m_color = {255, 255, 255, 255}; // Default: white
     std::string m_name = "Entity";
 };
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "game/paletted_tiles.hpp"
+#include <cstring>
+
+void PalettedTiles::assign(size_t count, TileType type) {
+    m_count = count;
+    fill(type);
+}
+
+void PalettedTiles::fill(TileType type) {
+    m_bits = 0;
+    m_uniform = type;
+    // Release the storage, not just its contents
+    std::vector<TileType>().swap(m_palette);
+    std::vector<uint32_t>().swap(m_uses);
+    std::vector<uint64_t>().swap(m_words);
+}
+
+bool PalettedTiles::set(size_t index, TileType type) {
+    if (m_bits == 0) {
+        if (type == m_uniform) {
+            return false;
+        }
+        // Split the uniform chunk: everything else keeps index 0
+        m_palette = {m_uniform, type};
+        m_uses = {static_cast<uint32_t>(m_count), 0};
+        m_bits = 1;
+        m_words.assign((m_count + 63) / 64, 0);
+    } else if (m_palette[readIndex(index)] == type) {
+        return false;
+    }
+
+    uint32_t previous = readIndex(index);
+    uint32_t next = paletteIndex(type);
+    --m_uses[previous];
+    ++m_uses[next];
+    writeIndex(index, next);
+
+    if (m_uses[next] == m_count) {
+        fill(type);
+    }
+    return true;
+}
+
+void PalettedTiles::copyTo(uint8_t* out) const {
+    if (m_bits == 0) {
+        std::memset(out, static_cast<uint8_t>(m_uniform), m_count);
+        return;
+    }
+
+    // Walk the words directly rather than recomputing each tile's position
+    const uint32_t mask = (1u << m_bits) - 1;
+    const size_t perWord = 64 / m_bits;
+    size_t index = 0;
+    for (uint64_t word : m_words) {
+        for (size_t i = 0; i < perWord && index < m_count; ++i, ++index) {
+            out[index] = static_cast<uint8_t>(m_palette[word & mask]);
+            word >>= m_bits;
+        }
+    }
+}
+
+size_t PalettedTiles::getMemoryUsage() const {
+    return m_palette.capacity() * sizeof(TileType) +
+           m_uses.capacity() * sizeof(uint32_t) +
+           m_words.capacity() * sizeof(uint64_t);
+}
+
+uint32_t PalettedTiles::paletteIndex(TileType type) {
+    uint32_t unused = static_cast<uint32_t>(m_palette.size());
+    for (uint32_t i = 0; i < m_palette.size(); ++i) {
+        if (m_palette[i] == type) {
+            return i;
+        }
+        if (m_uses[i] == 0 && unused == m_palette.size()) {
+            unused = i;
+        }
+    }
+
+    // Reuse an entry no tile points at any more
+    if (unused < m_palette.size()) {
+        m_palette[unused] = type;
+        return unused;
+    }
+
+    if (m_palette.size() == (size_t(1) << m_bits)) {
+        widen(m_bits * 2);
+    }
+    m_palette.push_back(type);
+    m_uses.push_back(0);
+    return unused;
+}
+
+void PalettedTiles::widen(int bits) {
+    std::vector<uint64_t> words((m_count * bits + 63) / 64, 0);
+    for (size_t i = 0; i < m_count; ++i) {
+        uint64_t value = readIndex(i);
+        size_t bit = i * bits;
+        words[bit >> 6] |= value << (bit & 63);
+    }
+    m_words.swap(words);
+    m_bits = bits;
+}
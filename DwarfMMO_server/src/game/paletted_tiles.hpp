@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "game/tile.hpp"
+
+// Tile types of one chunk as a small palette plus bit-packed indices into
+// it. Indices take 1, 2, 4 or 8 bits, widening when a type that doesn't fit
+// the palette appears; palette entries no tile uses any more are reused
+// first. A chunk holding a single type keeps just that value and no heap
+// storage, so memory follows how varied the world is, not how large.
+// Not thread-safe: World guards each chunk's tiles with the chunk's lock.
+class PalettedTiles {
+public:
+    PalettedTiles() : m_count(0), m_bits(0), m_uniform(TileType::EMPTY) {
+    }
+
+    // Resize to count tiles, all of one type
+    void assign(size_t count, TileType type);
+
+    // Set every tile to one type, dropping the packed storage
+    void fill(TileType type);
+
+    TileType get(size_t index) const {
+        return m_bits == 0 ? m_uniform : m_palette[readIndex(index)];
+    }
+
+    // Returns false if the tile already had that type
+    bool set(size_t index, TileType type);
+
+    // Write all tile types, one byte each, to out (size() bytes)
+    void copyTo(uint8_t* out) const;
+
+    // Whether every tile already has this type
+    bool isUniform(TileType type) const { return m_bits == 0 && m_uniform == type; }
+
+    size_t size() const { return m_count; }
+    int getBitsPerTile() const { return m_bits; }
+
+    // Heap bytes held for the palette and indices
+    size_t getMemoryUsage() const;
+
+private:
+    size_t m_count;
+
+    // 0 while every tile is m_uniform; then 1, 2, 4 or 8
+    int m_bits;
+    TileType m_uniform;
+
+    std::vector<TileType> m_palette;
+    // Tiles using each palette entry; a count of zero frees the entry
+    std::vector<uint32_t> m_uses;
+    // Indices, least significant bits first; never straddle a word
+    std::vector<uint64_t> m_words;
+
+    uint32_t readIndex(size_t index) const {
+        size_t bit = index * m_bits;
+        return static_cast<uint32_t>(m_words[bit >> 6] >> (bit & 63)) & ((1u << m_bits) - 1);
+    }
+    void writeIndex(size_t index, uint32_t value) {
+        size_t bit = index * m_bits;
+        uint64_t mask = static_cast<uint64_t>((1u << m_bits) - 1) << (bit & 63);
+        uint64_t& word = m_words[bit >> 6];
+        word = (word & ~mask) | (static_cast<uint64_t>(value) << (bit & 63));
+    }
+
+    // Palette index for a type, adding it (and widening) if needed
+    uint32_t paletteIndex(TileType type);
+
+    // Repack the indices at a larger width
+    void widen(int bits);
+};
@@ -0,0 +1,151 @@
+#include "game/solidity_map.hpp"
+#include <algorithm>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Index of the lowest set bit (value must not be 0)
+inline int lowestBit(uint64_t value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+} // namespace
+
+SolidityMap::SolidityMap(int width, int height)
+    : m_width(std::max(0, width)),
+      m_height(std::max(0, height)),
+      m_stride((static_cast<size_t>(m_width) + 63) / 64),
+      m_pageCount(m_stride * ((static_cast<size_t>(m_height) + PAGE_ROWS - 1) / PAGE_ROWS)),
+      m_pages(new std::atomic<std::atomic<uint64_t>*>[m_pageCount]),
+      m_allocatedPages(0) {
+    for (size_t i = 0; i < m_pageCount; ++i) {
+        m_pages[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+SolidityMap::~SolidityMap() {
+    for (size_t i = 0; i < m_pageCount; ++i) {
+        delete[] m_pages[i].load(std::memory_order_relaxed);
+    }
+}
+
+std::atomic<uint64_t>& SolidityMap::wordFor(int row, size_t column) {
+    std::atomic<std::atomic<uint64_t>*>& slot = m_pages[static_cast<size_t>(row / PAGE_ROWS) * m_stride + column];
+    std::atomic<uint64_t>* page = slot.load(std::memory_order_acquire);
+    if (!page) {
+        std::atomic<uint64_t>* created = new std::atomic<uint64_t>[PAGE_ROWS];
+        for (int i = 0; i < PAGE_ROWS; ++i) {
+            created[i].store(0, std::memory_order_relaxed);
+        }
+        // Another writer may have got there first (neighbouring chunks share pages)
+        if (slot.compare_exchange_strong(page, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            page = created;
+            m_allocatedPages.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            delete[] created;
+        }
+    }
+    return page[row % PAGE_ROWS];
+}
+
+void SolidityMap::apply(int row, size_t column, uint64_t mask, bool solid) {
+    if (solid) {
+        wordFor(row, column).fetch_or(mask, std::memory_order_relaxed);
+        return;
+    }
+    std::atomic<uint64_t>* page =
+        m_pages[static_cast<size_t>(row / PAGE_ROWS) * m_stride + column].load(std::memory_order_acquire);
+    if (page) {
+        page[row % PAGE_ROWS].fetch_and(~mask, std::memory_order_relaxed);
+    }
+}
+
+size_t SolidityMap::getMemoryUsage() const {
+    return m_pageCount * sizeof(std::atomic<std::atomic<uint64_t>*>) +
+           m_allocatedPages.load(std::memory_order_relaxed) * PAGE_ROWS * sizeof(std::atomic<uint64_t>);
+}
+
+uint64_t SolidityMap::spanMask(size_t column, int fromX, int toX) {
+    int base = static_cast<int>(column * 64);
+    int low = std::max(fromX - base, 0);
+    int high = std::min(toX - base, 64);
+    uint64_t upTo = high == 64 ? ~uint64_t(0) : (uint64_t(1) << high) - 1;
+    return upTo & ~((uint64_t(1) << low) - 1);
+}
+
+void SolidityMap::set(int x, int y, bool solid) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return;
+    }
+    apply(y, static_cast<size_t>(x) >> 6, uint64_t(1) << (x & 63), solid);
+}
+
+void SolidityMap::fillRect(int x, int y, int width, int height, bool solid) {
+    int minX = std::max(x, 0);
+    int minY = std::max(y, 0);
+    int maxX = std::min(x + width, m_width);
+    int maxY = std::min(y + height, m_height);
+    if (minX >= maxX || minY >= maxY) {
+        return;
+    }
+
+    for (int row = minY; row < maxY; ++row) {
+        for (size_t column = minX >> 6; column <= static_cast<size_t>(maxX - 1) >> 6; ++column) {
+            apply(row, column, spanMask(column, minX, maxX), solid);
+        }
+    }
+}
+
+bool SolidityMap::anySolid(int x, int y, int width, int height) const {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    // Compare in 64 bits so huge rectangles can't wrap around
+    if (x < 0 || y < 0 ||
+        static_cast<int64_t>(x) + width > m_width || static_cast<int64_t>(y) + height > m_height) {
+        return true;
+    }
+
+    size_t firstColumn = static_cast<size_t>(x) >> 6;
+    size_t lastColumn = static_cast<size_t>(x + width - 1) >> 6;
+    uint64_t firstMask = spanMask(firstColumn, x, x + width);
+    uint64_t lastMask = spanMask(lastColumn, x, x + width);
+    for (int row = y; row < y + height; ++row) {
+        // Full words in the middle are OR-ed together and tested once per row
+        uint64_t solid = wordAt(row, firstColumn) & firstMask;
+        for (size_t column = firstColumn + 1; column < lastColumn; ++column) {
+            solid |= wordAt(row, column);
+        }
+        if (lastColumn != firstColumn) {
+            solid |= wordAt(row, lastColumn) & lastMask;
+        }
+        if (solid != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int SolidityMap::findFreeInRow(int y, int fromX, int toX) const {
+    fromX = std::max(fromX, 0);
+    toX = std::min(toX, m_width);
+    if (y < 0 || y >= m_height || fromX >= toX) {
+        return -1;
+    }
+
+    for (size_t column = fromX >> 6; column <= static_cast<size_t>(toX - 1) >> 6; ++column) {
+        uint64_t free = ~wordAt(y, column) & spanMask(column, fromX, toX);
+        if (free != 0) {
+            return static_cast<int>(column * 64) + lowestBit(free);
+        }
+    }
+    return -1;
+}
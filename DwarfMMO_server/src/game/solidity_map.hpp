@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// One bit per tile, set where the tile is solid, kept by World next to the
+// tiles. Rows are padded to whole 64-bit words so row and rectangle queries
+// test 64 tiles per step instead of looking tiles up one by one. Words are
+// atomic: neighbouring chunks share words and are written under different
+// chunk locks, and readers take no lock at all. Everything outside the world
+// counts as solid.
+//
+// Words live in pages of one word column by PAGE_ROWS rows, allocated the
+// first time a bit in them is set; a missing page reads as all clear, so
+// open space costs only its page pointer.
+class SolidityMap {
+public:
+    SolidityMap(int width, int height);
+    ~SolidityMap();
+
+    SolidityMap(const SolidityMap&) = delete;
+    SolidityMap& operator=(const SolidityMap&) = delete;
+
+    bool isSolid(int x, int y) const {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+            return true;
+        }
+        return (wordAt(y, static_cast<size_t>(x) >> 6) >> (x & 63)) & 1u;
+    }
+
+    void set(int x, int y, bool solid);
+
+    // Set the bits of a rectangle, clipped to the world
+    void fillRect(int x, int y, int width, int height, bool solid);
+
+    // Whether any tile in the rectangle is solid (or outside the world)
+    bool anySolid(int x, int y, int width, int height) const;
+
+    // First non-solid x in [fromX, toX) on row y, or -1 if there is none
+    int findFreeInRow(int y, int fromX, int toX) const;
+
+    // Bytes held for the page table and the pages allocated so far
+    size_t getMemoryUsage() const;
+
+private:
+    static constexpr int PAGE_ROWS = 64;
+
+    int m_width;
+    int m_height;
+    // Words per row
+    size_t m_stride;
+    // Page (row / PAGE_ROWS, column) at index (row / PAGE_ROWS) * m_stride + column
+    size_t m_pageCount;
+    std::unique_ptr<std::atomic<std::atomic<uint64_t>*>[]> m_pages;
+    std::atomic<size_t> m_allocatedPages;
+
+    uint64_t wordAt(int row, size_t column) const {
+        const std::atomic<uint64_t>* page =
+            m_pages[static_cast<size_t>(row / PAGE_ROWS) * m_stride + column].load(std::memory_order_acquire);
+        return page ? page[row % PAGE_ROWS].load(std::memory_order_relaxed) : 0;
+    }
+
+    // The word to write, allocating its page if needed
+    std::atomic<uint64_t>& wordFor(int row, size_t column);
+
+    // Set or clear mask in one word; clearing never allocates a page
+    void apply(int row, size_t column, uint64_t mask, bool solid);
+
+    // Bits of word column `column` that fall in [fromX, toX)
+    static uint64_t spanMask(size_t column, int fromX, int toX);
+};
@@ -0,0 +1,216 @@
+#include "game/spatial_grid.hpp"
+#include <algorithm>
+#include <mutex>
+
+SpatialGrid::SpatialGrid(int width, int height, int cellSize)
+    : m_cellSize(std::max(1, cellSize)) {
+    m_columns = std::max(1, (width + m_cellSize - 1) / m_cellSize);
+    m_rows = std::max(1, (height + m_cellSize - 1) / m_cellSize);
+    m_cells.resize(static_cast<size_t>(m_columns) * m_rows);
+}
+
+void SpatialGrid::insert(int id, int x, int y, bool isPlayer) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    // Re-inserting an id replaces its old entry
+    auto it = m_cellOf.find(id);
+    if (it != m_cellOf.end()) {
+        eraseFromCell(m_cells[it->second], id);
+    }
+
+    int index = cellIndex(x, y);
+    m_cells[index].push_back(SpatialEntry{id, x, y, isPlayer});
+    m_cellOf[id] = index;
+}
+
+void SpatialGrid::remove(int id) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_cellOf.find(id);
+    if (it == m_cellOf.end()) {
+        return;
+    }
+
+    eraseFromCell(m_cells[it->second], id);
+    m_cellOf.erase(it);
+}
+
+void SpatialGrid::move(int id, int x, int y) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_cellOf.find(id);
+    if (it == m_cellOf.end()) {
+        return;
+    }
+
+    std::vector<SpatialEntry>& oldCell = m_cells[it->second];
+    auto entry = std::find_if(oldCell.begin(), oldCell.end(),
+                              [id](const SpatialEntry& e) { return e.id == id; });
+    if (entry == oldCell.end()) {
+        return;
+    }
+
+    // Most moves stay inside the same cell
+    int index = cellIndex(x, y);
+    if (index == it->second) {
+        entry->x = x;
+        entry->y = y;
+        return;
+    }
+
+    SpatialEntry moved{id, x, y, entry->isPlayer};
+    *entry = oldCell.back();
+    oldCell.pop_back();
+    m_cells[index].push_back(moved);
+    it->second = index;
+}
+
+EntitySpan SpatialGrid::queryRange(int x, int y, int range, bool playersOnly) const {
+    std::vector<SpatialEntry>& results = scratch();
+    results.clear();
+    if (range < 0) {
+        return EntitySpan();
+    }
+
+    long long rangeSquared = static_cast<long long>(range) * range;
+    int minCellX = cellX(x - range);
+    int maxCellX = cellX(x + range);
+    int minCellY = cellY(y - range);
+    int maxCellY = cellY(y + range);
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (int cy = minCellY; cy <= maxCellY; ++cy) {
+        for (int cx = minCellX; cx <= maxCellX; ++cx) {
+            for (const SpatialEntry& entry : m_cells[cy * m_columns + cx]) {
+                if (playersOnly && !entry.isPlayer) {
+                    continue;
+                }
+                long long dx = entry.x - x;
+                long long dy = entry.y - y;
+                if (dx * dx + dy * dy <= rangeSquared) {
+                    results.push_back(entry);
+                }
+            }
+        }
+    }
+
+    return EntitySpan(results.data(), results.size());
+}
+
+EntitySpan SpatialGrid::queryRect(int minX, int minY, int maxX, int maxY, bool playersOnly) const {
+    std::vector<SpatialEntry>& results = scratch();
+    results.clear();
+    if (minX > maxX || minY > maxY) {
+        return EntitySpan();
+    }
+
+    int minCellX = cellX(minX);
+    int maxCellX = cellX(maxX);
+    int minCellY = cellY(minY);
+    int maxCellY = cellY(maxY);
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (int cy = minCellY; cy <= maxCellY; ++cy) {
+        for (int cx = minCellX; cx <= maxCellX; ++cx) {
+            for (const SpatialEntry& entry : m_cells[cy * m_columns + cx]) {
+                if (playersOnly && !entry.isPlayer) {
+                    continue;
+                }
+                if (entry.x >= minX && entry.x <= maxX && entry.y >= minY && entry.y <= maxY) {
+                    results.push_back(entry);
+                }
+            }
+        }
+    }
+
+    return EntitySpan(results.data(), results.size());
+}
+
+EntitySpan SpatialGrid::queryNearest(int x, int y, size_t count, bool playersOnly) const {
+    std::vector<SpatialEntry>& results = scratch();
+    results.clear();
+    if (count == 0) {
+        return EntitySpan();
+    }
+
+    auto distanceSquared = [x, y](const SpatialEntry& entry) {
+        long long dx = entry.x - x;
+        long long dy = entry.y - y;
+        return dx * dx + dy * dy;
+    };
+    auto closer = [&distanceSquared](const SpatialEntry& a, const SpatialEntry& b) {
+        return distanceSquared(a) < distanceSquared(b);
+    };
+
+    int centerX = cellX(x);
+    int centerY = cellY(y);
+    int maxRing = std::max({centerX, m_columns - 1 - centerX, centerY, m_rows - 1 - centerY});
+
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    // Scan square rings of cells outwards from the query cell
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        for (int cy = centerY - ring; cy <= centerY + ring; ++cy) {
+            if (cy < 0 || cy >= m_rows) {
+                continue;
+            }
+
+            // Interior rows of the ring only contribute their two edge cells
+            bool edgeRow = (cy == centerY - ring || cy == centerY + ring);
+            int step = edgeRow ? 1 : std::max(1, 2 * ring);
+            for (int cx = centerX - ring; cx <= centerX + ring; cx += step) {
+                if (cx < 0 || cx >= m_columns) {
+                    continue;
+                }
+                for (const SpatialEntry& entry : m_cells[cy * m_columns + cx]) {
+                    if (!playersOnly || entry.isPlayer) {
+                        results.push_back(entry);
+                    }
+                }
+            }
+        }
+
+        if (results.size() < count) {
+            continue;
+        }
+
+        // Anything not scanned yet lies outside the scanned square, so it is at
+        // least this far away; stop once the count-th candidate is closer
+        long long bound = std::min({
+            static_cast<long long>(x) - static_cast<long long>(centerX - ring) * m_cellSize + 1,
+            static_cast<long long>(centerX + ring + 1) * m_cellSize - x,
+            static_cast<long long>(y) - static_cast<long long>(centerY - ring) * m_cellSize + 1,
+            static_cast<long long>(centerY + ring + 1) * m_cellSize - y
+        });
+        std::nth_element(results.begin(), results.begin() + (count - 1), results.end(), closer);
+        if (bound > 0 && distanceSquared(results[count - 1]) <= bound * bound) {
+            break;
+        }
+    }
+
+    size_t found = std::min(count, results.size());
+    std::partial_sort(results.begin(), results.begin() + found, results.end(), closer);
+    return EntitySpan(results.data(), found);
+}
+
+int SpatialGrid::cellX(int x) const {
+    int cell = x >= 0 ? x / m_cellSize : -1;
+    return std::clamp(cell, 0, m_columns - 1);
+}
+
+int SpatialGrid::cellY(int y) const {
+    int cell = y >= 0 ? y / m_cellSize : -1;
+    return std::clamp(cell, 0, m_rows - 1);
+}
+
+void SpatialGrid::eraseFromCell(std::vector<SpatialEntry>& cell, int id) {
+    auto it = std::find_if(cell.begin(), cell.end(),
+                           [id](const SpatialEntry& entry) { return entry.id == id; });
+    if (it != cell.end()) {
+        *it = cell.back();
+        cell.pop_back();
+    }
+}
+
+std::vector<SpatialEntry>& SpatialGrid::scratch() {
+    thread_local std::vector<SpatialEntry> results;
+    return results;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstddef>
+
+// Position of one entity as seen by the spatial index
+struct SpatialEntry {
+    int id;
+    int x;
+    int y;
+    bool isPlayer;
+};
+
+// Read-only view over query results. It points into a per-thread scratch
+// buffer owned by SpatialGrid, so it stays valid until the same thread runs
+// its next query.
+class EntitySpan {
+public:
+    EntitySpan(const SpatialEntry* data = nullptr, size_t size = 0)
+        : m_data(data), m_size(size) {
+    }
+
+    const SpatialEntry* begin() const { return m_data; }
+    const SpatialEntry* end() const { return m_data + m_size; }
+    const SpatialEntry& operator[](size_t index) const { return m_data[index]; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    const SpatialEntry* m_data;
+    size_t m_size;
+};
+
+// Uniform grid of square cells over the world. Each cell lists the entities
+// standing in it, so queries only visit the cells that overlap the query
+// area instead of every entity. Positions outside the world are clamped into
+// the border cells. Thread-safe: queries share a lock, updates take it
+// exclusively.
+class SpatialGrid {
+public:
+    SpatialGrid(int width, int height, int cellSize);
+
+    // Index maintenance
+    void insert(int id, int x, int y, bool isPlayer);
+    void remove(int id);
+    void move(int id, int x, int y);
+
+    // Entities within range (Euclidean) of (x, y)
+    EntitySpan queryRange(int x, int y, int range, bool playersOnly) const;
+
+    // Entities inside the inclusive rectangle
+    EntitySpan queryRect(int minX, int minY, int maxX, int maxY, bool playersOnly) const;
+
+    // Up to count entities closest to (x, y), nearest first
+    EntitySpan queryNearest(int x, int y, size_t count, bool playersOnly) const;
+
+    int getCellSize() const { return m_cellSize; }
+
+private:
+    int m_cellSize;
+    int m_columns;
+    int m_rows;
+    std::vector<std::vector<SpatialEntry>> m_cells;
+    std::unordered_map<int, int> m_cellOf;  // Entity id -> cell index
+    mutable std::shared_mutex m_mutex;
+
+    // Clamped cell coordinates for a world position
+    int cellX(int x) const;
+    int cellY(int y) const;
+    int cellIndex(int x, int y) const { return cellY(y) * m_columns + cellX(x); }
+
+    // Remove an entry from a cell without preserving order
+    static void eraseFromCell(std::vector<SpatialEntry>& cell, int id);
+
+    // Per-thread result buffer behind every EntitySpan
+    static std::vector<SpatialEntry>& scratch();
+};
@@ -2,18 +2,65 @@
 #include "game/entity.hpp"
 #include "game/player.hpp"
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
 
-World::World(int width, int height)
-    : m_width(width), m_height(height) {
-    
-    // Initialize tiles
-    m_tiles.resize(width * height, Tile(TileType::EMPTY));
-    
-    // Generate the world
-    generateWorld();
-    
-    std::cout << "World created with size " << width << "x" << height << std::endl;
+namespace {
+
+// FNV-1a: the same seed string must give the same world on every platform
+uint64_t hashSeed(const std::string& seed) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (char c : seed) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// splitmix64 step
+uint64_t nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+World::World(int width, int height, int chunkSize, const std::string& seed)
+    : m_width(width), m_height(height),
+      m_chunkSize(std::max(1, chunkSize)),
+      m_chunkColumns((width + m_chunkSize - 1) / m_chunkSize),
+      m_chunkRows((height + m_chunkSize - 1) / m_chunkSize),
+      m_chunkCount(static_cast<size_t>(m_chunkColumns) * m_chunkRows),
+      m_chunks(new std::atomic<Chunk*>[m_chunkCount]),
+      m_seed(hashSeed(seed)),
+      m_solidity(width, height),
+      m_spatialGrid(width, height, SPATIAL_CELL_SIZE) {
+    for (size_t i = 0; i < m_chunkCount; ++i) {
+        m_chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+    std::cout << "World created with size " << width << "x" << height
+              << " (seed \"" << seed << "\")" << std::endl;
+}
+
+World::~World() {
+    for (size_t i = 0; i < m_chunkCount; ++i) {
+        delete m_chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+World::Chunk& World::ensureChunk(size_t index) const {
+    Chunk* chunk = m_chunks[index].load(std::memory_order_relaxed);
+    if (!chunk) {
+        std::unique_ptr<Chunk> created(new Chunk());
+        generateChunk(index, *created);
+        // Pairs with the acquire in generateChunksIn: a chunk seen as
+        // existing has its solid bits visible too
+        chunk = created.release();
+        m_chunks[index].store(chunk, std::memory_order_release);
+    }
+    return *chunk;
 }
 
 void World::update(float deltaTime) {
@@ -24,35 +71,209 @@ void World::update(float deltaTime) {
     }
 }
 
+template<typename Fn>
+void World::forEachChunkIn(int x, int y, int width, int height, Fn&& fn) {
+    // Clip to the world first
+    int minX = std::max(x, 0);
+    int minY = std::max(y, 0);
+    int maxX = std::min(x + width, m_width);
+    int maxY = std::min(y + height, m_height);
+    if (minX >= maxX || minY >= maxY) {
+        return;
+    }
+    
+    for (int chunkY = minY / m_chunkSize; chunkY <= (maxY - 1) / m_chunkSize; ++chunkY) {
+        for (int chunkX = minX / m_chunkSize; chunkX <= (maxX - 1) / m_chunkSize; ++chunkX) {
+            size_t index = chunkIndex(chunkX, chunkY);
+            std::lock_guard<std::mutex> lock(chunkLock(index));
+            fn(index, ensureChunk(index),
+               std::max(minX, chunkX * m_chunkSize), std::max(minY, chunkY * m_chunkSize),
+               std::min(maxX, (chunkX + 1) * m_chunkSize), std::min(maxY, (chunkY + 1) * m_chunkSize));
+        }
+    }
+}
+
 void World::setTile(int x, int y, TileType type) {
-    std::lock_guard<std::mutex> lock(m_worldMutex);
     if (isInBounds(x, y)) {
-        m_tiles[getIndex(x, y)] = Tile(type);
+        size_t index = chunkIndexOf(x, y);
+        std::lock_guard<std::mutex> lock(chunkLock(index));
+        Chunk& chunk = ensureChunk(index);
+        if (writeTile(chunk, x, y, type)) {
+            touch(index, chunk);
+        }
     }
 }
 
+void World::fillRegion(int x, int y, int width, int height, const uint8_t* mask, TileType type) {
+    forEachChunkIn(x, y, width, height, [&](size_t index, Chunk& chunk, int minX, int minY, int maxX, int maxY) {
+        // A chunk covered completely collapses to the one type; one that
+        // already is that type is left alone, version and cached frame included
+        if (!mask && maxX - minX == m_chunkSize && maxY - minY == m_chunkSize) {
+            if (chunk.tiles.isUniform(type)) {
+                return;
+            }
+            chunk.tiles.fill(type);
+            m_solidity.fillRect(minX, minY, m_chunkSize, m_chunkSize, tileProperties(type).solid);
+            touch(index, chunk);
+            return;
+        }
+        
+        bool changed = false;
+        for (int tileY = minY; tileY < maxY; ++tileY) {
+            for (int tileX = minX; tileX < maxX; ++tileX) {
+                size_t index = static_cast<size_t>(tileY - y) * width + (tileX - x);
+                if (!mask || ((mask[index >> 3] >> (index & 7)) & 1u)) {
+                    changed |= writeTile(chunk, tileX, tileY, type);
+                }
+            }
+        }
+        if (changed) {
+            touch(index, chunk);
+        }
+    });
+}
+
+void World::setTiles(int x, int y, int width, int height, const uint8_t* mask, const uint8_t* types) {
+    forEachChunkIn(x, y, width, height, [&](size_t index, Chunk& chunk, int minX, int minY, int maxX, int maxY) {
+        bool changed = false;
+        for (int tileY = minY; tileY < maxY; ++tileY) {
+            for (int tileX = minX; tileX < maxX; ++tileX) {
+                size_t index = static_cast<size_t>(tileY - y) * width + (tileX - x);
+                if ((mask[index >> 3] >> (index & 7)) & 1u) {
+                    changed |= writeTile(chunk, tileX, tileY, static_cast<TileType>(types[index]));
+                }
+            }
+        }
+        if (changed) {
+            touch(index, chunk);
+        }
+    });
+}
+
 Tile World::getTile(int x, int y) const {
     if (isInBounds(x, y)) {
-        return m_tiles[getIndex(x, y)];
+        size_t index = chunkIndexOf(x, y);
+        std::lock_guard<std::mutex> lock(chunkLock(index));
+        return Tile(ensureChunk(index).tiles.get(tileIndex(x, y)));
     }
     return Tile(TileType::WALL); // Default to wall for out-of-bounds
 }
 
+uint32_t World::getChunkVersion(int chunkX, int chunkY) const {
+    if (chunkX < 0 || chunkY < 0 || chunkX >= m_chunkColumns || chunkY >= m_chunkRows) {
+        return 0;
+    }
+    // A chunk not generated yet has never been modified
+    size_t index = chunkIndex(chunkX, chunkY);
+    std::lock_guard<std::mutex> lock(chunkLock(index));
+    const Chunk* chunk = m_chunks[index].load(std::memory_order_relaxed);
+    return chunk ? chunk->version : 1;
+}
+
+uint32_t World::copyChunkTiles(int chunkX, int chunkY, std::vector<uint8_t>& types) const {
+    types.assign(static_cast<size_t>(m_chunkSize) * m_chunkSize, static_cast<uint8_t>(TileType::WALL));
+    if (chunkX < 0 || chunkY < 0 || chunkX >= m_chunkColumns || chunkY >= m_chunkRows) {
+        return 0;
+    }
+    
+    // The chunk's block is already in wire order; tiles and version are
+    // read under one lock so they always match
+    size_t index = chunkIndex(chunkX, chunkY);
+    std::lock_guard<std::mutex> lock(chunkLock(index));
+    const Chunk& chunk = ensureChunk(index);
+    chunk.tiles.copyTo(types.data());
+    return chunk.version;
+}
+
+void World::takeDirtyChunks(std::vector<ChunkCoord>& out) {
+    size_t first = out.size();
+    {
+        std::lock_guard<std::mutex> lock(m_dirtyMutex);
+        out.insert(out.end(), m_dirtyChunks.begin(), m_dirtyChunks.end());
+        m_dirtyChunks.clear();
+    }
+    
+    // An edit landing between the swap and here is already covered by the
+    // chunk being reported now
+    for (size_t i = first; i < out.size(); ++i) {
+        size_t index = chunkIndex(out[i].x, out[i].y);
+        std::lock_guard<std::mutex> lock(chunkLock(index));
+        m_chunks[index].load(std::memory_order_relaxed)->dirty = false;
+    }
+}
+
+size_t World::getTileMemoryUsage() const {
+    size_t total = m_chunkCount * sizeof(std::atomic<Chunk*>) + m_solidity.getMemoryUsage();
+    for (size_t index = 0; index < m_chunkCount; ++index) {
+        // Only chunks that exist need their lock
+        if (!m_chunks[index].load(std::memory_order_acquire)) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(chunkLock(index));
+        total += sizeof(Chunk) + m_chunks[index].load(std::memory_order_relaxed)->tiles.getMemoryUsage();
+    }
+    return total;
+}
+
 bool World::isSolid(int x, int y) const {
-    if (!isInBounds(x, y)) {
-        return true; // Out of bounds is solid
+    if (isInBounds(x, y)) {
+        generateChunksIn(x, y, x + 1, y + 1);
+    }
+    return m_solidity.isSolid(x, y);
+}
+
+bool World::anySolidInRect(int x, int y, int width, int height) const {
+    generateChunksIn(x, y, static_cast<int64_t>(x) + width, static_cast<int64_t>(y) + height);
+    return m_solidity.anySolid(x, y, width, height);
+}
+
+int World::findFreeTileInRow(int y, int fromX, int toX) const {
+    generateChunksIn(fromX, y, toX, static_cast<int64_t>(y) + 1);
+    return m_solidity.findFreeInRow(y, fromX, toX);
+}
+
+void World::generateChunksIn(int64_t minX, int64_t minY, int64_t maxX, int64_t maxY) const {
+    minX = std::max<int64_t>(minX, 0);
+    minY = std::max<int64_t>(minY, 0);
+    maxX = std::min<int64_t>(maxX, m_width);
+    maxY = std::min<int64_t>(maxY, m_height);
+    if (minX >= maxX || minY >= maxY) {
+        return;
+    }
+    
+    for (int64_t chunkY = minY / m_chunkSize; chunkY <= (maxY - 1) / m_chunkSize; ++chunkY) {
+        for (int64_t chunkX = minX / m_chunkSize; chunkX <= (maxX - 1) / m_chunkSize; ++chunkX) {
+            size_t index = chunkIndex(static_cast<int>(chunkX), static_cast<int>(chunkY));
+            if (!m_chunks[index].load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(chunkLock(index));
+                ensureChunk(index);
+            }
+        }
     }
-    return m_tiles[getIndex(x, y)].solid;
 }
 
 void World::addEntity(std::shared_ptr<Entity> entity) {
     std::lock_guard<std::mutex> lock(m_entityMutex);
     m_entities[entity->getId()] = entity;
+    
+    // Classify once here so queries never need a dynamic cast
+    bool isPlayer = dynamic_cast<Player*>(entity.get()) != nullptr;
+    m_spatialGrid.insert(entity->getId(), entity->getX(), entity->getY(), isPlayer);
+    entity->setWorld(this);
 }
 
 void World::removeEntity(int id) {
     std::lock_guard<std::mutex> lock(m_entityMutex);
-    m_entities.erase(id);
+    auto it = m_entities.find(id);
+    if (it != m_entities.end()) {
+        it->second->setWorld(nullptr);
+        m_entities.erase(it);
+    }
+    m_spatialGrid.remove(id);
+}
+
+void World::updateEntityPosition(int id, int x, int y) {
+    m_spatialGrid.move(id, x, y);
 }
 
 std::shared_ptr<Entity> World::getEntity(int id) {
@@ -64,77 +285,75 @@ std::shared_ptr<Entity> World::getEntity(int id) {
     return nullptr;
 }
 
-std::vector<std::shared_ptr<Player>> World::getPlayersInRange(int x, int y, int range) {
-    std::vector<std::shared_ptr<Player>> players;
-    std::lock_guard<std::mutex> lock(m_entityMutex);
-    
-    for (auto& pair : m_entities) {
-        auto entity = pair.second;
-        auto player = std::dynamic_pointer_cast<Player>(entity);
-        
-        if (player) {
-            int dx = player->getX() - x;
-            int dy = player->getY() - y;
-            int distanceSquared = dx * dx + dy * dy;
-            
-            if (distanceSquared <= range * range) {
-                players.push_back(player);
-            }
-        }
-    }
-    
-    return players;
+EntitySpan World::getPlayersInRange(int x, int y, int range) const {
+    return m_spatialGrid.queryRange(x, y, range, true);
+}
+
+EntitySpan World::getEntitiesInRect(int minX, int minY, int maxX, int maxY, bool playersOnly) const {
+    return m_spatialGrid.queryRect(minX, minY, maxX, maxY, playersOnly);
 }
 
-void World::generateWorld() {
-    // Fill the world with empty space
-    for (int y = 0; y < m_height; ++y) {
-        for (int x = 0; x < m_width; ++x) {
-            setTile(x, y, TileType::EMPTY);
+EntitySpan World::getNearestEntities(int x, int y, size_t count, bool playersOnly) const {
+    return m_spatialGrid.queryNearest(x, y, count, playersOnly);
+}
+
+void World::generateChunk(size_t index, Chunk& chunk) const {
+    ChunkCoord coord{static_cast<int>(index % m_chunkColumns), static_cast<int>(index / m_chunkColumns)};
+    int originX = coord.x * m_chunkSize;
+    int originY = coord.y * m_chunkSize;
+    int maxX = std::min(originX + m_chunkSize, m_width);
+    int maxY = std::min(originY + m_chunkSize, m_height);
+    
+    // Empty space, with walls past the world edge
+    size_t count = static_cast<size_t>(m_chunkSize) * m_chunkSize;
+    if (isChunkInterior(coord.x, coord.y)) {
+        chunk.tiles.assign(count, TileType::EMPTY);
+    } else {
+        chunk.tiles.assign(count, TileType::WALL);
+        for (int y = originY; y < maxY; ++y) {
+            for (int x = originX; x < maxX; ++x) {
+                chunk.tiles.set(tileIndex(x, y), TileType::EMPTY);
+            }
         }
     }
     
-    // Create a central area with floor
+    // A central area with floor, walled in; most chunks are nowhere near it
     int centerX = m_width / 2;
     int centerY = m_height / 2;
     int roomSize = std::min(m_width, m_height) / 4;
-    
-    for (int y = centerY - roomSize; y <= centerY + roomSize; ++y) {
-        for (int x = centerX - roomSize; x <= centerX + roomSize; ++x) {
-            if (isInBounds(x, y)) {
-                setTile(x, y, TileType::FLOOR);
-            }
-        }
+    int wallDistance = roomSize + 1;
+    if (maxX <= centerX - wallDistance || originX > centerX + wallDistance ||
+        maxY <= centerY - wallDistance || originY > centerY + wallDistance) {
+        return;
     }
     
-    // Add some walls around the central area
-    for (int y = centerY - roomSize - 1; y <= centerY + roomSize + 1; ++y) {
-        for (int x = centerX - roomSize - 1; x <= centerX + roomSize + 1; ++x) {
-            if (isInBounds(x, y)) {
-                if (x == centerX - roomSize - 1 || x == centerX + roomSize + 1 ||
-                    y == centerY - roomSize - 1 || y == centerY + roomSize + 1) {
-                    setTile(x, y, TileType::WALL);
+    // Obstacles depend only on the seed and this chunk, whatever order
+    // chunks are generated in
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) | static_cast<uint32_t>(coord.y);
+    uint64_t state = m_seed ^ nextRandom(key);
+    for (int y = originY; y < maxY; ++y) {
+        for (int x = originX; x < maxX; ++x) {
+            int dx = std::abs(x - centerX);
+            int dy = std::abs(y - centerY);
+            TileType type = TileType::EMPTY;
+            if (dx <= roomSize && dy <= roomSize) {
+                // Floor with some random walls for obstacles, about one per
+                // 2*roomSize tiles; don't block the center
+                type = TileType::FLOOR;
+                if (roomSize > 0 && nextRandom(state) % (roomSize * 2) == 0 && (dx > 2 || dy > 2)) {
+                    type = TileType::WALL;
                 }
+            } else if (std::max(dx, dy) == wallDistance) {
+                // Walls around the room with an opening in the middle of each side
+                type = (dx == 0 || dy == 0) ? TileType::FLOOR : TileType::WALL;
             }
-        }
-    }
-    
-    // Create openings in the walls
-    setTile(centerX, centerY - roomSize - 1, TileType::FLOOR); // North
-    setTile(centerX, centerY + roomSize + 1, TileType::FLOOR); // South
-    setTile(centerX - roomSize - 1, centerY, TileType::FLOOR); // West
-    setTile(centerX + roomSize + 1, centerY, TileType::FLOOR); // East
-    
-    // Add some random walls inside the room for obstacles
-    for (int i = 0; i < roomSize * 2; ++i) {
-        int x = centerX - roomSize + (rand() % (roomSize * 2));
-        int y = centerY - roomSize + (rand() % (roomSize * 2));
-        
-        if (isInBounds(x, y)) {
-            // Don't block the center or the openings
-            if (abs(x - centerX) > 2 || abs(y - centerY) > 2) {
-                setTile(x, y, TileType::WALL);
+            
+            if (type != TileType::EMPTY) {
+                chunk.tiles.set(tileIndex(x, y), type);
+                if (tileProperties(type).solid) {
+                    m_solidity.set(x, y, true);
+                }
             }
         }
     }
-}
\ No newline at end of file
+}
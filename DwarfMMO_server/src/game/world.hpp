@@ -1,91 +1,196 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
-#include <SDL2/SDL.h>
+#include "game/tile.hpp"
+#include "game/paletted_tiles.hpp"
+#include "game/solidity_map.hpp"
+#include "game/spatial_grid.hpp"
 
 // Forward declarations
 class Entity;
 class Player;
 
-// Tile type enum
-enum class TileType {
-    EMPTY,
-    FLOOR,
-    WALL,
-    GREEN_WALL
-};
+// Integer division rounding towards negative infinity (tile -> chunk coordinates)
+inline int floorDiv(int value, int divisor) {
+    int quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
 
-// Tile structure
-struct Tile {
-    TileType type;
-    char symbol;
-    SDL_Color color;
-    bool solid;
-    
-    Tile(TileType t = TileType::EMPTY) : type(t) {
-        switch (t) {
-            case TileType::EMPTY:
-                symbol = ' ';
-                color = {0, 0, 0, 255};
-                solid = false;
-                break;
-            case TileType::FLOOR:
-                symbol = '.';
-                color = {100, 100, 100, 255};
-                solid = false;
-                break;
-            case TileType::WALL:
-                symbol = '#';
-                color = {150, 150, 150, 255};
-                solid = true;
-                break;
-            case TileType::GREEN_WALL:
-                symbol = '#';
-                color = {0, 200, 0, 255};
-                solid = true;
-                break;
-        }
-    }
+// Chunk coordinates (tile coordinates divided by the chunk size)
+struct ChunkCoord {
+    int x;
+    int y;
 };
 
 class World {
 public:
-    World(int width = 100, int height = 100);
-    ~World() = default;
+    // Chunks are generated from the seed the first time anything touches
+    // them, so construction costs nothing per tile
+    World(int width = 100, int height = 100, int chunkSize = 16, const std::string& seed = "");
+    ~World();
     
     void update(float deltaTime);
     
     // World modification
     void setTile(int x, int y, TileType type);
+    
+    // Set the tiles of a width x height rectangle whose bit is set in mask
+    // (row-major, least significant bit first; null sets all of them) to one
+    // type, locking each chunk it touches once. Tiles outside the world are
+    // skipped.
+    void fillRegion(int x, int y, int width, int height, const uint8_t* mask, TileType type);
+    
+    // Same, with the new type of every masked tile taken from types
+    // (one entry per tile of the rectangle)
+    void setTiles(int x, int y, int width, int height, const uint8_t* mask, const uint8_t* types);
+    
     Tile getTile(int x, int y) const;
+    
+    // Collision queries read the solidity layer and take no lock once the
+    // chunks involved exist; anything outside the world is solid
     bool isSolid(int x, int y) const;
+    bool anySolidInRect(int x, int y, int width, int height) const;
+    
+    // First non-solid x in [fromX, toX) on row y, or -1
+    int findFreeTileInRow(int y, int fromX, int toX) const;
+    
+    // Chunk versions start at 1 and change whenever a tile in the chunk is
+    // set, so anything derived from a chunk can be checked for staleness.
+    // Chunks outside the world report version 0.
+    uint32_t getChunkVersion(int chunkX, int chunkY) const;
+    
+    // Copy the tile types of a chunk (row-major, chunkSize x chunkSize; tiles
+    // past the world edge read as WALL) and return the version they belong to
+    uint32_t copyChunkTiles(int chunkX, int chunkY, std::vector<uint8_t>& types) const;
+    
+    // Append the chunks modified since the last call and clear their dirty flags
+    void takeDirtyChunks(std::vector<ChunkCoord>& out);
+    
+    // Bytes held for tiles: the chunk table, every generated chunk with its
+    // palette and indices, and the solidity layer
+    size_t getTileMemoryUsage() const;
     
     // Entity management
     void addEntity(std::shared_ptr<Entity> entity);
     void removeEntity(int id);
     std::shared_ptr<Entity> getEntity(int id);
     
-    // Get all players within a certain range
-    std::vector<std::shared_ptr<Player>> getPlayersInRange(int x, int y, int range);
+    // Called by Entity::setPosition to keep the spatial index current
+    void updateEntityPosition(int id, int x, int y);
+    
+    // Spatial queries. Results live in a per-thread buffer that the calling
+    // thread's next query reuses, so copy out anything that must outlive it.
+    EntitySpan getPlayersInRange(int x, int y, int range) const;
+    EntitySpan getEntitiesInRect(int minX, int minY, int maxX, int maxY, bool playersOnly = false) const;
+    EntitySpan getNearestEntities(int x, int y, size_t count, bool playersOnly = false) const;
     
     // Getters
     int getWidth() const { return m_width; }
     int getHeight() const { return m_height; }
+    int getChunkSize() const { return m_chunkSize; }
     
 private:
+    // Tiles of one chunk, paletted, with the version and dirty flag that go
+    // with them. Records exist only for chunks that have been generated, so
+    // an untouched world costs one pointer per chunk. Tiles past the world
+    // edge exist in the block but stay WALL and are never written.
+    struct Chunk {
+        PalettedTiles tiles;
+        uint32_t version = 1;
+        bool dirty = false;
+    };
+    
     int m_width;
     int m_height;
-    std::vector<Tile> m_tiles;
-    std::mutex m_worldMutex;
+    int m_chunkSize;
+    int m_chunkColumns;
+    int m_chunkRows;
+    
+    // Row-major chunk table, null until a chunk is first used. Chunks are
+    // created from const queries too, and the solidity queries check for
+    // them without a lock, hence atomic.
+    size_t m_chunkCount;
+    std::unique_ptr<std::atomic<Chunk*>[]> m_chunks;
+    
+    // Each chunk is guarded by the lock its index maps to, so edits in
+    // different chunks rarely contend without a mutex per chunk
+    static constexpr size_t CHUNK_LOCK_STRIPES = 64;
+    mutable std::mutex m_chunkLocks[CHUNK_LOCK_STRIPES];
+    
+    // Hash of the world seed; with a chunk's coordinates it determines the
+    // chunk's generated contents
+    uint64_t m_seed;
+    
+    // Solid bit of every tile, updated along with the tiles (including
+    // when a chunk is generated)
+    mutable SolidityMap m_solidity;
+    
+    // Chunks whose dirty flag was raised since the last takeDirtyChunks
+    std::mutex m_dirtyMutex;
+    std::vector<ChunkCoord> m_dirtyChunks;
+    
     std::mutex m_entityMutex;
     std::unordered_map<int, std::shared_ptr<Entity>> m_entities;
     
-    // Helper for index calculation
-    inline int getIndex(int x, int y) const {
-        return y * m_width + x;
+    // Entity positions bucketed into cells
+    static constexpr int SPATIAL_CELL_SIZE = 16;
+    SpatialGrid m_spatialGrid;
+    
+    inline size_t chunkIndex(int chunkX, int chunkY) const {
+        return static_cast<size_t>(chunkY) * m_chunkColumns + chunkX;
+    }
+    inline size_t chunkIndexOf(int x, int y) const {
+        return chunkIndex(x / m_chunkSize, y / m_chunkSize);
+    }
+    inline std::mutex& chunkLock(size_t index) const {
+        return m_chunkLocks[index % CHUNK_LOCK_STRIPES];
+    }
+    // Index of a tile inside its chunk (tile in bounds)
+    inline size_t tileIndex(int x, int y) const {
+        return static_cast<size_t>(y % m_chunkSize) * m_chunkSize + x % m_chunkSize;
+    }
+    
+    // The chunk at an index, generated first if this is its first use
+    // (call with the chunk's lock held)
+    Chunk& ensureChunk(size_t index) const;
+    
+    // Set a tile and its solid bit (call with the chunk's lock held);
+    // false if the tile already had that type
+    bool writeTile(Chunk& chunk, int x, int y, TileType type) {
+        if (!chunk.tiles.set(tileIndex(x, y), type)) {
+            return false;
+        }
+        m_solidity.set(x, y, tileProperties(type).solid);
+        return true;
+    }
+    
+    // Record a modification (call with the chunk's lock held)
+    void touch(size_t index, Chunk& chunk) {
+        ++chunk.version;
+        if (!chunk.dirty) {
+            chunk.dirty = true;
+            std::lock_guard<std::mutex> lock(m_dirtyMutex);
+            m_dirtyChunks.push_back(ChunkCoord{static_cast<int>(index % m_chunkColumns),
+                                               static_cast<int>(index / m_chunkColumns)});
+        }
+    }
+    
+    // Call fn(index, chunk, minX, minY, maxX, maxY) with each chunk's lock
+    // held, for every chunk overlapping the rectangle; the bounds (world
+    // coordinates, max exclusive) are the part of the rectangle inside that
+    // chunk
+    template<typename Fn>
+    void forEachChunkIn(int x, int y, int width, int height, Fn&& fn);
+    
+    // Whether a chunk lies entirely inside the world
+    inline bool isChunkInterior(int chunkX, int chunkY) const {
+        return (chunkX + 1) * m_chunkSize <= m_width && (chunkY + 1) * m_chunkSize <= m_height;
     }
     
     // Check if coordinates are within bounds
@@ -93,6 +198,11 @@ private:
         return x >= 0 && x < m_width && y >= 0 && y < m_height;
     }
     
-    // Initialize the world with a simple layout
-    void generateWorld();
+    // Generate every chunk overlapping a rectangle (max exclusive) that
+    // doesn't exist yet, for the lock-free solidity queries
+    void generateChunksIn(int64_t minX, int64_t minY, int64_t maxX, int64_t maxY) const;
+    
+    // Lay out one chunk: a walled room of floor in the middle of the world,
+    // with obstacles drawn from the seed and the chunk's coordinates
+    void generateChunk(size_t index, Chunk& chunk) const;
 };
\ No newline at end of file
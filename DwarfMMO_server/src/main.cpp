@@ -4,10 +4,12 @@
 #include <chrono>
 #include <atomic>
 #include <cstdlib>
+#include <algorithm>
 #include <boost/asio.hpp>
 
 #include "server/server.hpp"
 #include "server/config.hpp"
+#include "server/io_context_pool.hpp"
 
 // Global server instance for signal handling
 ServerPtr g_server;
@@ -60,6 +62,7 @@ int main(int argc, char* argv[]) {
         if (argc > 1) {
             config.port = static_cast<uint16_t>(std::stoi(argv[1]));
         }
+        config.validate();
         
         std::cout << "Starting DwarfMMO Server on port " << config.port << std::endl;
         
@@ -67,25 +70,21 @@ int main(int argc, char* argv[]) {
         std::signal(SIGINT, signalHandler);
         std::signal(SIGTERM, signalHandler);
         
+        // Size the IO thread pool
+        size_t ioThreads = config.ioThreads;
+        if (ioThreads == 0) {
+            ioThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        
         // Create and start the server
-        boost::asio::io_context ioContext;
-        g_server = std::make_shared<Server>(ioContext, config);
+        IoContextPool ioPool(ioThreads);
+        g_server = std::make_shared<Server>(ioPool, config);
         g_server->start();
         
-        // Run the io_context in the main thread with work guard to prevent early exit
-        boost::asio::executor_work_guard<boost::asio::io_context::executor_type> workGuard = 
-            boost::asio::make_work_guard(ioContext);
-        
         std::cout << "Server running. Press Ctrl+C to stop." << std::endl;
         
-        // Run IO context in a separate thread
-        std::thread ioThread([&ioContext]() {
-            try {
-                ioContext.run();
-            } catch (const std::exception& e) {
-                std::cerr << "IO context error: " << e.what() << std::endl;
-            }
-        });
+        // Run the IO contexts, one per thread
+        ioPool.run();
         
         // Wait for shutdown signal in main thread
         while (!g_shutdownRequested.load()) {
@@ -95,13 +94,8 @@ int main(int argc, char* argv[]) {
         // Clean shutdown sequence
         std::cout << "Initiating clean shutdown..." << std::endl;
         
-        // Cancel the work guard to allow io_context to exit when all handlers complete
-        workGuard.reset();
-        
-        // Wait for IO thread to finish
-        if (ioThread.joinable()) {
-            ioThread.join();
-        }
+        // Release the work guards and wait for the IO threads to finish
+        ioPool.stop();
         
         // Final cleanup
         g_server.reset();
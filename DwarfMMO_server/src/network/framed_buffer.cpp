@@ -0,0 +1,35 @@
+#include "network/framed_buffer.hpp"
+#include <algorithm>
+
+FramedBuffer::FramedBuffer(std::shared_ptr<const std::vector<uint8_t>> bytes)
+    : m_bytes(std::move(bytes)) {
+}
+
+FramedBuffer FramedBuffer::fromPacket(const Packet& packet) {
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    
+    // Size the frame exactly once, then serialize straight after the header
+    bytes->reserve(4 + packet.serializedSize());
+    bytes->resize(4);
+    packet.serialize(*bytes);
+    
+    writeFrameHeader(*bytes);
+    return FramedBuffer(std::move(bytes));
+}
+
+FramedBuffer FramedBuffer::fromRawData(const uint8_t* data, size_t size) {
+    auto bytes = std::make_shared<std::vector<uint8_t>>(4 + size);
+    std::copy(data, data + size, bytes->begin() + 4);
+    
+    writeFrameHeader(*bytes);
+    return FramedBuffer(std::move(bytes));
+}
+
+void FramedBuffer::writeFrameHeader(std::vector<uint8_t>& bytes) {
+    // Fill in the packet length header (4 bytes)
+    uint32_t length = static_cast<uint32_t>(bytes.size() - 4);
+    bytes[0] = static_cast<uint8_t>((length >> 24) & 0xFF);
+    bytes[1] = static_cast<uint8_t>((length >> 16) & 0xFF);
+    bytes[2] = static_cast<uint8_t>((length >> 8) & 0xFF);
+    bytes[3] = static_cast<uint8_t>(length & 0xFF);
+}
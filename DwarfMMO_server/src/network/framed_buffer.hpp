@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include "network/packet.hpp"
+
+// Immutable, reference-counted wire frame: 4-byte length header + packet data.
+// A broadcast serializes its packet once and every recipient's send queue
+// holds a reference to the same bytes.
+class FramedBuffer {
+public:
+    FramedBuffer() = default;
+    
+    // Serialize a packet into a new frame
+    static FramedBuffer fromPacket(const Packet& packet);
+    
+    // Frame already serialized packet bytes (e.g. a view being forwarded)
+    static FramedBuffer fromRawData(const uint8_t* data, size_t size);
+    
+    const uint8_t* data() const { return m_bytes ? m_bytes->data() : nullptr; }
+    size_t size() const { return m_bytes ? m_bytes->size() : 0; }
+    bool empty() const { return size() == 0; }
+    
+    // The packet bytes after the length header
+    const uint8_t* packetData() const { return data() + 4; }
+    size_t packetSize() const { return empty() ? 0 : size() - 4; }
+    
+private:
+    explicit FramedBuffer(std::shared_ptr<const std::vector<uint8_t>> bytes);
+    
+    // Write the length of everything after the 4-byte header into it
+    static void writeFrameHeader(std::vector<uint8_t>& bytes);
+    
+    std::shared_ptr<const std::vector<uint8_t>> m_bytes;
+};
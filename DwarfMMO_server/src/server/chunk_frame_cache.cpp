@@ -0,0 +1,48 @@
+#include "server/chunk_frame_cache.hpp"
+#include "game/world.hpp"
+#include "network/packet.hpp"
+#include "network/chunk_codec.hpp"
+
+ChunkFrameCache::ChunkFrameCache(const World& world)
+    : m_world(world),
+      m_columns((world.getWidth() + world.getChunkSize() - 1) / world.getChunkSize()),
+      m_rows((world.getHeight() + world.getChunkSize() - 1) / world.getChunkSize()),
+      m_entries(static_cast<size_t>(m_columns) * m_rows) {
+}
+
+FramedBuffer ChunkFrameCache::get(const ChunkCoord& chunk, bool compressed, bool& encoded) {
+    encoded = false;
+    if (chunk.x < 0 || chunk.y < 0 || chunk.x >= m_columns || chunk.y >= m_rows) {
+        return FramedBuffer();
+    }
+
+    Entry& entry = m_entries[static_cast<size_t>(chunk.y) * m_columns + chunk.x];
+    Frame& slot = compressed ? entry.compressed : entry.raw;
+    if (slot.version == 0 || slot.version != m_world.getChunkVersion(chunk.x, chunk.y)) {
+        encode(chunk, compressed, slot);
+        encoded = true;
+    }
+    return slot.frame;
+}
+
+void ChunkFrameCache::invalidate(const ChunkCoord& chunk) {
+    if (chunk.x < 0 || chunk.y < 0 || chunk.x >= m_columns || chunk.y >= m_rows) {
+        return;
+    }
+    m_entries[static_cast<size_t>(chunk.y) * m_columns + chunk.x] = Entry();
+}
+
+void ChunkFrameCache::encode(const ChunkCoord& chunk, bool compressed, Frame& slot) {
+    // Stale or never sent: encode from a consistent copy of the tiles
+    const int chunkSize = m_world.getChunkSize();
+    slot.version = m_world.copyChunkTiles(chunk.x, chunk.y, m_tiles);
+    if (compressed) {
+        CompressedChunkPacket packet(chunk.x * chunkSize, chunk.y * chunkSize, chunkSize, chunkSize);
+        encodeChunkTiles(m_tiles.data(), m_tiles.size(), packet.getEncodedTiles());
+        slot.frame = FramedBuffer::fromPacket(packet);
+    } else {
+        WorldChunkPacket packet(chunk.x * chunkSize, chunk.y * chunkSize, chunkSize, chunkSize);
+        packet.setTileData(m_tiles);
+        slot.frame = FramedBuffer::fromPacket(packet);
+    }
+}
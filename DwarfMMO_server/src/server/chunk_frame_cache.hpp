@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "network/framed_buffer.hpp"
+#include "server/chunk_streamer.hpp"
+
+class World;
+
+// Framed chunk packets for every chunk, shared by all sessions, in both the
+// raw WorldChunk and the CompressedChunk encoding. Each frame remembers the
+// chunk version it was encoded from; a chunk is only re-encoded when its
+// version has moved on, so joins and streaming hand the same immutable
+// buffer to every socket. Only used from the game thread.
+class ChunkFrameCache {
+public:
+    explicit ChunkFrameCache(const World& world);
+
+    // Current frame for a chunk, compressed or raw; encoded==true if it had
+    // to be rebuilt. Chunks outside the world get an empty frame.
+    FramedBuffer get(const ChunkCoord& chunk, bool compressed, bool& encoded);
+
+    // Drop a chunk's frames (it changed); the next get() encodes it again
+    void invalidate(const ChunkCoord& chunk);
+
+private:
+    struct Frame {
+        uint32_t version = 0;
+        FramedBuffer frame;
+    };
+    struct Entry {
+        Frame raw;
+        Frame compressed;
+    };
+
+    const World& m_world;
+    int m_columns;
+    int m_rows;
+    std::vector<Entry> m_entries;
+
+    // Encoding scratch
+    std::vector<uint8_t> m_tiles;
+
+    // Encode the chunk's current tiles into slot
+    void encode(const ChunkCoord& chunk, bool compressed, Frame& slot);
+};
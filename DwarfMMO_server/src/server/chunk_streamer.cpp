@@ -0,0 +1,130 @@
+#include "server/chunk_streamer.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+ChunkStreamer::ChunkStreamer(int viewRadius, int columns, int rows)
+    : m_viewRadius(std::max(0, viewRadius)),
+      m_columns(columns),
+      m_rows(rows),
+      m_hasCenter(false),
+      m_centerX(0),
+      m_centerY(0),
+      m_hasPrefetchCenter(false),
+      m_prefetchX(0),
+      m_prefetchY(0) {
+}
+
+bool ChunkStreamer::setCenter(int chunkX, int chunkY, std::vector<ChunkCoord>& unloaded) {
+    if (m_hasCenter && chunkX == m_centerX && chunkY == m_centerY) {
+        return false;
+    }
+    m_hasCenter = true;
+    m_centerX = chunkX;
+    m_centerY = chunkY;
+
+    // The prefetch set was relative to the old center
+    m_hasPrefetchCenter = false;
+    m_prefetch.clear();
+
+    // Unload what fell beyond the margin around the view
+    int keepRadius = m_viewRadius + PREFETCH_MARGIN;
+    for (auto it = m_loaded.begin(); it != m_loaded.end(); ) {
+        int x = static_cast<int32_t>(*it >> 32);
+        int y = static_cast<int32_t>(*it & 0xFFFFFFFFu);
+        if (std::abs(x - chunkX) > keepRadius || std::abs(y - chunkY) > keepRadius) {
+            unloaded.push_back(ChunkCoord{x, y});
+            it = m_loaded.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Requeue everything in view that isn't loaded, relative to the new center
+    m_pending.clear();
+    for (int y = chunkY - m_viewRadius; y <= chunkY + m_viewRadius; ++y) {
+        for (int x = chunkX - m_viewRadius; x <= chunkX + m_viewRadius; ++x) {
+            if (inWorld(x, y) && m_loaded.count(key(x, y)) == 0) {
+                m_pending.push_back(ChunkCoord{x, y});
+            }
+        }
+    }
+    sortByDistance(m_pending);
+    return true;
+}
+
+bool ChunkStreamer::popNext(ChunkCoord& chunk) {
+    if (m_pending.empty()) {
+        return false;
+    }
+    chunk = m_pending.back();
+    m_pending.pop_back();
+    m_loaded.insert(key(chunk.x, chunk.y));
+    return true;
+}
+
+void ChunkStreamer::setPrefetchCenter(int chunkX, int chunkY) {
+    if (!m_hasCenter) {
+        return;
+    }
+
+    chunkX = std::clamp(chunkX, m_centerX - PREFETCH_MARGIN, m_centerX + PREFETCH_MARGIN);
+    chunkY = std::clamp(chunkY, m_centerY - PREFETCH_MARGIN, m_centerY + PREFETCH_MARGIN);
+    if (m_hasPrefetchCenter && chunkX == m_prefetchX && chunkY == m_prefetchY) {
+        return;
+    }
+    m_hasPrefetchCenter = true;
+    m_prefetchX = chunkX;
+    m_prefetchY = chunkY;
+
+    // Chunks in the current view are already pending, so only the part of
+    // the predicted view outside it is prefetched
+    m_prefetch.clear();
+    for (int y = chunkY - m_viewRadius; y <= chunkY + m_viewRadius; ++y) {
+        for (int x = chunkX - m_viewRadius; x <= chunkX + m_viewRadius; ++x) {
+            bool inView = std::abs(x - m_centerX) <= m_viewRadius && std::abs(y - m_centerY) <= m_viewRadius;
+            if (!inView && inWorld(x, y) && m_loaded.count(key(x, y)) == 0) {
+                m_prefetch.push_back(ChunkCoord{x, y});
+            }
+        }
+    }
+    sortByDistance(m_prefetch);
+
+    // Then the ring just outside the view, which the prediction misses when
+    // the player turns. It goes first in the vector so it pops last.
+    std::vector<ChunkCoord> ring;
+    int ringRadius = m_viewRadius + 1;
+    for (int y = m_centerY - ringRadius; y <= m_centerY + ringRadius; ++y) {
+        for (int x = m_centerX - ringRadius; x <= m_centerX + ringRadius; ++x) {
+            bool onRing = std::max(std::abs(x - m_centerX), std::abs(y - m_centerY)) == ringRadius;
+            bool ahead = std::abs(x - chunkX) <= m_viewRadius && std::abs(y - chunkY) <= m_viewRadius;
+            if (onRing && !ahead && inWorld(x, y) && m_loaded.count(key(x, y)) == 0) {
+                ring.push_back(ChunkCoord{x, y});
+            }
+        }
+    }
+    sortByDistance(ring);
+    m_prefetch.insert(m_prefetch.begin(), ring.begin(), ring.end());
+}
+
+bool ChunkStreamer::popNextPrefetch(ChunkCoord& chunk) {
+    if (m_prefetch.empty()) {
+        return false;
+    }
+    chunk = m_prefetch.back();
+    m_prefetch.pop_back();
+    m_loaded.insert(key(chunk.x, chunk.y));
+    return true;
+}
+
+void ChunkStreamer::sortByDistance(std::vector<ChunkCoord>& chunks) const {
+    int centerX = m_centerX;
+    int centerY = m_centerY;
+    auto distance = [centerX, centerY](const ChunkCoord& c) {
+        int dx = c.x - centerX;
+        int dy = c.y - centerY;
+        return dx * dx + dy * dy;
+    };
+    std::sort(chunks.begin(), chunks.end(), [&distance](const ChunkCoord& a, const ChunkCoord& b) {
+        return distance(a) > distance(b);
+    });
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_set>
+#include "game/world.hpp"
+
+// Tracks which chunks one client has loaded and which it still needs.
+// Recentering on the player's chunk queues the chunks that came into view,
+// nearest first, and unloads loaded chunks that are now more than
+// PREFETCH_MARGIN chunks beyond the view radius. The margin holds the chunks
+// prefetched ahead of a moving player and stops a player pacing along a
+// border from reloading the same chunks. Only used from the game thread.
+class ChunkStreamer {
+public:
+    // How far beyond the view chunks may be prefetched and stay loaded
+    static constexpr int PREFETCH_MARGIN = 2;
+
+    // columns/rows: chunks covering the world; nothing outside is streamed
+    ChunkStreamer(int viewRadius, int columns, int rows);
+
+    // Move the view to a chunk. Chunks that must be unloaded are appended to
+    // unloaded. Returns false if the center didn't change.
+    bool setCenter(int chunkX, int chunkY, std::vector<ChunkCoord>& unloaded);
+
+    // Take the nearest chunk still to be sent; it counts as loaded from now on
+    bool popNext(ChunkCoord& chunk);
+
+    // Queue the chunks in view of a predicted center (at most PREFETCH_MARGIN
+    // chunks from the current one) that aren't in the current view, then
+    // the ring of chunks just outside the current view
+    void setPrefetchCenter(int chunkX, int chunkY);
+
+    // Take the nearest chunk to prefetch; it counts as loaded from now on
+    bool popNextPrefetch(ChunkCoord& chunk);
+
+    bool isLoaded(const ChunkCoord& chunk) const { return m_loaded.count(key(chunk.x, chunk.y)) != 0; }
+    bool hasPending() const { return !m_pending.empty(); }
+    size_t getLoadedCount() const { return m_loaded.size(); }
+
+private:
+    int m_viewRadius;
+    int m_columns;
+    int m_rows;
+
+    bool m_hasCenter;
+    int m_centerX;
+    int m_centerY;
+
+    std::unordered_set<uint64_t> m_loaded;
+
+    // Chunks in view but not sent yet, farthest first so the nearest pops off the back
+    std::vector<ChunkCoord> m_pending;
+
+    // Chunks ahead of the player, same order; rebuilt when the prediction moves
+    bool m_hasPrefetchCenter;
+    int m_prefetchX;
+    int m_prefetchY;
+    std::vector<ChunkCoord> m_prefetch;
+
+    // Sort chunks farthest from the current center first
+    void sortByDistance(std::vector<ChunkCoord>& chunks) const;
+
+    static uint64_t key(int x, int y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    bool inWorld(int x, int y) const { return x >= 0 && y >= 0 && x < m_columns && y < m_rows; }
+};
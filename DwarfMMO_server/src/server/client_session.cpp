@@ -2,6 +2,13 @@
 #include "server/server.hpp"
 #include <iostream>
 #include <thread>
+#include <algorithm>
+#include <iterator>
+
+// Number of chunks needed to cover a world dimension
+static int chunksAcross(int tiles, int chunkSize) {
+    return (tiles + chunkSize - 1) / chunkSize;
+}
 
 ClientSession::ClientSession(boost::asio::io_context& ioContext, Server* server)
     : m_ioContext(ioContext),
@@ -9,9 +16,31 @@ ClientSession::ClientSession(boost::asio::io_context& ioContext, Server* server)
       m_server(server),
       m_connected(false), // Initialize atomic bool
       m_playerId(0),
-      m_receiveBuffer(1024),
-      m_expectedLength(0),
-      m_sending(false) {
+      m_flushScheduled(false),
+      m_coalesceSends(server->getConfig().coalesceSends),
+      m_writeBatchBytes(0),
+      m_writeBatchFrames(0),
+      m_sending(false),
+      m_flushRequested(false),
+      m_batchFull(false),
+      m_queuedBytes(0),
+      m_queuedFrames(0),
+      m_overBudget(false),
+      m_sendStalled(false),
+      m_udpToken(0),
+      m_udpBound(false),
+      m_udpSendSequence(1),
+      m_lastSnapshotTick(0),
+      m_ackedSnapshotTick(0),
+      m_lastSeenAck(0),
+      m_ackProgressTick(0),
+      m_lastSnapshotUnreliable(false),
+      m_udpSnapshots(true),
+      m_compressedChunks(false),
+      m_chunkStreamer(static_cast<int>(server->getConfig().viewRadiusChunks),
+                      chunksAcross(server->getWorld()->getWidth(), server->getWorld()->getChunkSize()),
+                      chunksAcross(server->getWorld()->getHeight(), server->getWorld()->getChunkSize())),
+      m_roundTripSeconds(0.2f) {
 }
 
 ClientSession::~ClientSession() {
@@ -36,8 +65,8 @@ void ClientSession::start() {
 }
 
 void ClientSession::sendShutdownNotification() {
-    // Only send if still connected
-    if (!m_connected.load()) {
+    // Only send if still connected, and never block on a stalled socket
+    if (!m_connected.load() || m_sendStalled.load()) {
         return;
     }
     
@@ -46,24 +75,11 @@ void ClientSession::sendShutdownNotification() {
         DisconnectPacket packet("Server shutting down");
         
         // Use synchronous send to ensure it gets through before socket close
-        std::vector<uint8_t> packetData;
-        packet.serialize(packetData);
-        
-        // Add packet length header (4 bytes)
-        std::vector<uint8_t> buffer(4 + packetData.size());
-        uint32_t length = static_cast<uint32_t>(packetData.size());
-        
-        buffer[0] = static_cast<uint8_t>((length >> 24) & 0xFF);
-        buffer[1] = static_cast<uint8_t>((length >> 16) & 0xFF);
-        buffer[2] = static_cast<uint8_t>((length >> 8) & 0xFF);
-        buffer[3] = static_cast<uint8_t>(length & 0xFF);
-        
-        // Copy packet data
-        std::copy(packetData.begin(), packetData.end(), buffer.begin() + 4);
+        FramedBuffer frame = FramedBuffer::fromPacket(packet);
         
         // Send directly (synchronous)
         boost::system::error_code ec;
-        boost::asio::write(m_socket, boost::asio::buffer(buffer), ec);
+        boost::asio::write(m_socket, boost::asio::buffer(frame.data(), frame.size()), ec);
         
         if (ec) {
             std::cerr << "Error sending shutdown notification: " << ec.message() << std::endl;
@@ -94,6 +110,11 @@ void ClientSession::close() {
     // Send shutdown notification first before player cleanup
     sendShutdownNotification();
     
+    // Stop routing datagrams to this session
+    if (m_udpToken != 0 && m_server && m_server->getUdpChannel()) {
+        m_server->getUdpChannel()->unregisterSession(m_udpToken);
+    }
+    
     // Player cleanup - do this first as it's safer
     try {
         // Remove player from the game world
@@ -155,39 +176,158 @@ void ClientSession::sendPacket(const Packet& packet) {
     }
     
     try {
-        // Serialize packet
-        std::vector<uint8_t> packetData;
-        packet.serialize(packetData);
-        
-        // Add packet length header (4 bytes)
-        std::vector<uint8_t> buffer(4 + packetData.size());
-        uint32_t length = static_cast<uint32_t>(packetData.size());
-        
-        buffer[0] = static_cast<uint8_t>((length >> 24) & 0xFF);
-        buffer[1] = static_cast<uint8_t>((length >> 16) & 0xFF);
-        buffer[2] = static_cast<uint8_t>((length >> 8) & 0xFF);
-        buffer[3] = static_cast<uint8_t>(length & 0xFF);
-        
-        // Copy packet data
-        std::copy(packetData.begin(), packetData.end(), buffer.begin() + 4);
-        
-        // Add to send queue
-        m_sendQueue.push(std::move(buffer));
-        
-        // Start sending if not already sending
-        if (!m_sending) {
-            startSend();
-        }
+        sendFrame(FramedBuffer::fromPacket(packet));
     } catch (const std::exception& e) {
         std::cerr << "Error preparing packet: " << e.what() << std::endl;
     }
 }
 
+void ClientSession::sendFrame(const FramedBuffer& frame) {
+    if (!m_connected.load() || frame.empty()) {
+        return;
+    }
+    
+    m_queuedBytes.fetch_add(frame.size(), std::memory_order_relaxed);
+    m_queuedFrames.fetch_add(1, std::memory_order_relaxed);
+    m_server->getMetrics().framesQueued.fetch_add(1, std::memory_order_relaxed);
+    
+    // Add to send queue and make sure the IO thread will flush it; in
+    // coalescing mode the end of the tick does that instead
+    m_sendQueue.push(frame);
+    if (!m_coalesceSends) {
+        scheduleFlush();
+    }
+}
+
+void ClientSession::sendSupersedingFrame(uint64_t key, const FramedBuffer& frame) {
+    if (!m_connected.load() || frame.empty()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_supersedeMutex);
+        auto result = m_supersedingFrames.try_emplace(key, frame);
+        if (result.second) {
+            m_queuedBytes.fetch_add(frame.size(), std::memory_order_relaxed);
+            m_queuedFrames.fetch_add(1, std::memory_order_relaxed);
+            m_server->getMetrics().framesQueued.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // An older update for the same entity is still waiting; replace it
+            FramedBuffer& queued = result.first->second;
+            m_queuedBytes.fetch_add(frame.size(), std::memory_order_relaxed);
+            m_queuedBytes.fetch_sub(queued.size(), std::memory_order_relaxed);
+            queued = frame;
+            m_server->getMetrics().framesSuperseded.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    
+    if (!m_coalesceSends) {
+        scheduleFlush();
+    }
+}
+
+void ClientSession::flushSends() {
+    scheduleFlush();
+}
+
+void ClientSession::cancelSupersedingFrame(uint64_t key) {
+    std::lock_guard<std::mutex> lock(m_supersedeMutex);
+    auto it = m_supersedingFrames.find(key);
+    if (it != m_supersedingFrames.end()) {
+        m_queuedBytes.fetch_sub(it->second.size(), std::memory_order_relaxed);
+        m_queuedFrames.fetch_sub(1, std::memory_order_relaxed);
+        m_supersedingFrames.erase(it);
+    }
+}
+
+bool ClientSession::sendUnreliable(const uint8_t* packet, size_t size) {
+    if (!m_udpBound.load(std::memory_order_acquire) || !m_connected.load()) {
+        return false;
+    }
+    
+    uint32_t sequence = m_udpSendSequence.fetch_add(1, std::memory_order_relaxed);
+    m_server->getUdpChannel()->sendTo(m_udpEndpoint, makeDatagram(sequence, packet, size));
+    return true;
+}
+
+void ClientSession::bindUdpEndpoint(const udp::endpoint& endpoint) {
+    // The endpoint is written once, before the flag publishes it
+    if (m_udpBound.load(std::memory_order_acquire)) {
+        return;
+    }
+    m_udpEndpoint = endpoint;
+    m_udpBound.store(true, std::memory_order_release);
+    
+    std::cout << "UDP side channel ready for client " << m_playerId << " (" << endpoint << ")" << std::endl;
+}
+
+void ClientSession::receiveDatagram(uint32_t sequence, const uint8_t* packet, size_t size) {
+    // Only position updates may arrive unreliably
+    PlayerPositionView view;
+    if (!view.bind(packet, size)) {
+        return;
+    }
+    
+    // Handle it on this session's IO thread like any TCP packet
+    std::vector<uint8_t> bytes(packet, packet + size);
+    boost::asio::post(m_ioContext, [self = shared_from_this(), sequence, bytes = std::move(bytes)]() {
+        // Drop datagrams that arrive after a newer one
+        if (!self->m_connected.load() || !self->m_udpReceiveFilter.accept(self->m_playerId, sequence)) {
+            return;
+        }
+        self->processPacket(bytes.data(), bytes.size());
+    });
+}
+
 void ClientSession::update(float deltaTime) {
     // Update player
     if (m_player) {
         m_player->update(deltaTime, m_server->getWorld());
     }
+    
+    checkBackpressure();
+    streamChunks();
+}
+
+void ClientSession::checkBackpressure() {
+    if (!m_connected.load()) {
+        return;
+    }
+    
+    const ServerConfig& config = m_server->getConfig();
+    size_t queuedBytes = m_queuedBytes.load(std::memory_order_relaxed);
+    size_t queuedFrames = m_queuedFrames.load(std::memory_order_relaxed);
+    m_server->getMetrics().recordQueuedBytes(queuedBytes);
+    
+    if (queuedBytes <= config.sendBudgetBytes && queuedFrames <= config.sendQueueHighWater) {
+        m_overBudget = false;
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    if (!m_overBudget) {
+        m_overBudget = true;
+        m_overBudgetSince = now;
+        std::cerr << "Client " << m_playerId << " is falling behind: " << queuedFrames
+                  << " frames / " << queuedBytes << " bytes queued" << std::endl;
+        return;
+    }
+    
+    if (now - m_overBudgetSince < std::chrono::milliseconds(config.slowConsumerGraceMs)) {
+        return;
+    }
+    
+    std::cerr << "Disconnecting slow client " << m_playerId << " after "
+              << config.slowConsumerGraceMs << " ms over its send budget" << std::endl;
+    m_server->getMetrics().slowConsumerDisconnects.fetch_add(1, std::memory_order_relaxed);
+    m_overBudget = false;
+    m_sendStalled.store(true);
+    
+    // close() takes the clients mutex, which the tick is holding; run it on the IO thread
+    boost::asio::post(m_ioContext, [self = shared_from_this()]() {
+        self->close();
+    });
 }
 
 tcp::socket& ClientSession::getSocket() {
@@ -207,164 +347,204 @@ void ClientSession::startReceive() {
         return;
     }
     
-    // Read packet length header (4 bytes)
-    boost::asio::async_read(
-        m_socket,
-        boost::asio::buffer(m_receiveBuffer.data(), 4),
+    // Read whatever is available into the ring
+    m_receiveBuffer.prepare();
+    m_socket.async_read_some(
+        boost::asio::buffer(m_receiveBuffer.writePtr(), m_receiveBuffer.writable()),
         [self = shared_from_this()](const boost::system::error_code& error, size_t bytesTransferred) {
-            self->handleReceiveHeader(error, bytesTransferred);
+            self->handleReceive(error, bytesTransferred);
         }
     );
 }
 
-void ClientSession::handleReceiveHeader(const boost::system::error_code& error, size_t bytesTransferred) {
+void ClientSession::handleReceive(const boost::system::error_code& error, size_t bytesTransferred) {
     if (error) {
         // Only log errors that aren't operation_aborted (server shutdown) or eof (client disconnect)
         if (error != boost::asio::error::operation_aborted && 
             error != boost::asio::error::eof) {
-            std::cerr << "Receive header error: " << error.message() << std::endl;
+            std::cerr << "Receive error: " << error.message() << std::endl;
         }
         close();
         return;
     }
     
-    // Parse packet length
-    m_expectedLength = 
-        (static_cast<uint32_t>(m_receiveBuffer[0]) << 24) |
-        (static_cast<uint32_t>(m_receiveBuffer[1]) << 16) |
-        (static_cast<uint32_t>(m_receiveBuffer[2]) << 8) |
-        static_cast<uint32_t>(m_receiveBuffer[3]);
+    m_receiveBuffer.commit(bytesTransferred);
     
-    // Sanity check on packet size
-    if (m_expectedLength == 0 || m_expectedLength > 1024 * 1024) {
-        std::cerr << "Invalid packet size: " << m_expectedLength << std::endl;
-        close();
-        return;
+    // Process every complete packet in this batch
+    const uint8_t* data = nullptr;
+    uint32_t length = 0;
+    ReceiveBuffer::FrameStatus status;
+    while ((status = m_receiveBuffer.nextFrame(data, length)) == ReceiveBuffer::FrameStatus::COMPLETE) {
+        processPacket(data, length);
+        
+        if (!m_connected.load()) {
+            return;
+        }
     }
     
-    // Resize buffer if needed
-    if (m_receiveBuffer.size() < m_expectedLength) {
-        m_receiveBuffer.resize(m_expectedLength);
+    if (status == ReceiveBuffer::FrameStatus::INVALID) {
+        std::cerr << "Invalid packet size from client " << m_playerId << std::endl;
+        close();
+        return;
     }
     
-    // Read packet body
-    boost::asio::async_read(
-        m_socket,
-        boost::asio::buffer(m_receiveBuffer.data(), m_expectedLength),
-        [self = shared_from_this()](const boost::system::error_code& error, size_t bytesTransferred) {
-            self->handleReceiveBody(error, bytesTransferred);
-        }
-    );
+    // Start receiving more data
+    startReceive();
 }
 
-void ClientSession::handleReceiveBody(const boost::system::error_code& error, size_t bytesTransferred) {
-    if (error) {
-        // Only log errors that aren't operation_aborted (server shutdown) or eof (client disconnect)
-        if (error != boost::asio::error::operation_aborted && 
-            error != boost::asio::error::eof) {
-            std::cerr << "Receive body error: " << error.message() << std::endl;
-        }
-        close();
+template<typename View, void (ClientSession::*Handler)(const View&)>
+void ClientSession::dispatchView(const uint8_t* data, size_t size) {
+    View view;
+    if (!view.bind(data, size)) {
+        std::cerr << "Invalid packet format (type " << static_cast<int>(data[0]) << ")" << std::endl;
         return;
     }
-    
-    // Process received packet
-    processPacket(m_receiveBuffer.data(), bytesTransferred);
-    
-    // Start receiving next packet
-    startReceive();
+    (this->*Handler)(view);
+}
+
+constexpr ClientSession::PacketHandlerTable ClientSession::makePacketHandlers() {
+    PacketHandlerTable handlers{};
+    handlers[static_cast<size_t>(PacketType::CONNECT_REQUEST)] =
+        &ClientSession::dispatchView<ConnectRequestView, &ClientSession::handleConnectRequest>;
+    handlers[static_cast<size_t>(PacketType::PLAYER_POSITION)] =
+        &ClientSession::dispatchView<PlayerPositionView, &ClientSession::handlePlayerPosition>;
+    handlers[static_cast<size_t>(PacketType::PLAYER_APPEARANCE)] =
+        &ClientSession::dispatchView<PlayerAppearanceView, &ClientSession::handlePlayerAppearance>;
+    handlers[static_cast<size_t>(PacketType::WORLD_MODIFICATION)] =
+        &ClientSession::dispatchView<WorldModificationView, &ClientSession::handleWorldModification>;
+    handlers[static_cast<size_t>(PacketType::REGION_EDIT)] =
+        &ClientSession::dispatchView<RegionEditView, &ClientSession::handleRegionEdit>;
+    handlers[static_cast<size_t>(PacketType::SNAPSHOT_ACK)] =
+        &ClientSession::dispatchView<SnapshotAckView, &ClientSession::handleSnapshotAck>;
+    
+    // Client can't send these, ignore
+    handlers[static_cast<size_t>(PacketType::WORLD_CHUNK)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::PLAYER_LIST)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::UDP_OFFER)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::ENTITY_SPAWN)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::ENTITY_DESPAWN)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::SNAPSHOT)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::CHUNK_UNLOAD)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::CHUNK_DELTA)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::REGION_UPDATE)] = &ClientSession::ignorePacket;
+    handlers[static_cast<size_t>(PacketType::COMPRESSED_CHUNK)] = &ClientSession::ignorePacket;
+    
+    // Only valid as a datagram, handled by the UDP channel
+    handlers[static_cast<size_t>(PacketType::UDP_HELLO)] = &ClientSession::ignorePacket;
+    return handlers;
 }
 
 void ClientSession::processPacket(const uint8_t* data, size_t size) {
+    static constexpr PacketHandlerTable handlers = makePacketHandlers();
+    
+    // Frames are never empty, so the type byte is always present
+    uint8_t type = data[0];
+    PacketHandler handler = type < handlers.size() ? handlers[type] : nullptr;
+    if (!handler) {
+        std::cerr << "Unhandled packet type: " << static_cast<int>(type) << std::endl;
+        return;
+    }
+    
     try {
-        // Create packet from raw data
-        auto packet = Packet::createFromRawData(data, size);
-        
-        if (!packet) {
-            std::cerr << "Invalid packet format" << std::endl;
-            return;
-        }
-        
-        // Handle packet based on type
-        switch (packet->getType()) {
-            case PacketType::CONNECT_REQUEST:
-                handleConnectRequest(static_cast<const ConnectRequestPacket&>(*packet));
-                break;
-                
-            case PacketType::PLAYER_POSITION:
-                handlePlayerPosition(static_cast<const PlayerPositionPacket&>(*packet));
-                break;
-                
-            case PacketType::WORLD_MODIFICATION:
-                handleWorldModification(static_cast<const WorldModificationPacket&>(*packet));
-                break;
-                
-            case PacketType::PLAYER_APPEARANCE:
-            {
-                // Get the appearance info
-                const PlayerAppearancePacket& appearancePacket = static_cast<const PlayerAppearancePacket&>(*packet);
-                
-                // Update the player's appearance
-                if (m_player) {
-                    SDL_Color color = {
-                        appearancePacket.getColorR(),
-                        appearancePacket.getColorG(),
-                        appearancePacket.getColorB(),
-                        255
-                    };
-                    m_player->setColor(color);
-                    // SDL_Color otherColor = {255, 255, 0, 255}; // Yellow
-                    // m_player->setColor(otherColor)
-                    m_player->setSymbol(appearancePacket.getSymbol());
-                }
-                
-                // Broadcast to all other clients
-                std::lock_guard<std::mutex> lock(m_server->getClientsMutex());
-                for (const auto& pair : m_server->getClients()) {
-                    // Skip sending to self
-                    if (pair.first != m_playerId) {
-                        pair.second->sendPacket(appearancePacket);
-                    }
-                }
-                break;
-            }
-                
-            case PacketType::WORLD_CHUNK:
-            {
-                // Client can't send these, ignore
-                break;
-            }
-                
-            case PacketType::PLAYER_LIST:
-            {
-                // Client can't send these, ignore
-                break;
-            }
-                
-            default:
-                std::cerr << "Unhandled packet type: " << static_cast<int>(packet->getType()) << std::endl;
-                break;
-        }
+        (this->*handler)(data, size);
     } catch (const std::exception& e) {
         std::cerr << "Error processing packet: " << e.what() << std::endl;
     }
 }
 
+void ClientSession::ignorePacket(const uint8_t*, size_t) {
+    // Server-to-client packets echoed back by a client are dropped
+}
+
+void ClientSession::scheduleFlush() {
+    // Only one flush needs to be in flight; it drains everything pushed so far
+    if (m_flushScheduled.exchange(true)) {
+        return;
+    }
+    
+    boost::asio::post(m_ioContext, [self = shared_from_this()]() {
+        // Clear the flag before draining so a concurrent push schedules again
+        self->m_flushScheduled.store(false);
+        
+        // A write in progress picks up the new packets when it completes
+        if (!self->m_sending) {
+            self->startSend();
+        } else if (self->m_coalesceSends) {
+            self->m_flushRequested = true;
+        }
+    });
+}
+
+bool ClientSession::batchHasRoom() const {
+    // Asio hands at most this many buffers to a single writev
+    static constexpr size_t MAX_GATHER_BUFFERS = 64;
+    
+    // Coalesced writes are a single buffer, capped by size instead
+    static constexpr size_t MAX_COALESCED_BYTES = 64 * 1024;
+    
+    if (m_coalesceSends) {
+        return m_coalescedBytes.size() < MAX_COALESCED_BYTES;
+    }
+    return m_writeBatch.size() < MAX_GATHER_BUFFERS;
+}
+
+void ClientSession::addToBatch(FramedBuffer frame) {
+    m_writeBatchBytes += frame.size();
+    ++m_writeBatchFrames;
+    
+    if (m_coalesceSends) {
+        // Copy into the session's contiguous buffer; the shared frame is released here
+        m_coalescedBytes.insert(m_coalescedBytes.end(), frame.data(), frame.data() + frame.size());
+    } else {
+        m_writeBatch.push_back(std::move(frame));
+    }
+}
+
 void ClientSession::startSend() {
-    if (!m_connected.load() || m_sendQueue.empty()) {
+    if (!m_connected.load()) {
+        m_sending = false;
+        return;
+    }
+    
+    // Drain everything pending into one batch: ordered frames first, then
+    // the latest superseding update per entity
+    m_writeBatchBytes = 0;
+    m_writeBatchFrames = 0;
+    FramedBuffer frame;
+    while (batchHasRoom() && m_sendQueue.pop(frame)) {
+        addToBatch(std::move(frame));
+    }
+    
+    if (batchHasRoom()) {
+        std::lock_guard<std::mutex> lock(m_supersedeMutex);
+        auto it = m_supersedingFrames.begin();
+        while (batchHasRoom() && it != m_supersedingFrames.end()) {
+            addToBatch(std::move(it->second));
+            it = m_supersedingFrames.erase(it);
+        }
+    }
+    
+    if (m_writeBatchFrames == 0) {
         m_sending = false;
         return;
     }
     
     m_sending = true;
+    m_batchFull = !batchHasRoom();
     
-    // Get the next packet from the queue
-    const auto& buffer = m_sendQueue.front();
+    m_writeBuffers.clear();
+    if (m_coalesceSends) {
+        m_writeBuffers.push_back(boost::asio::buffer(m_coalescedBytes));
+    } else {
+        for (const auto& batched : m_writeBatch) {
+            m_writeBuffers.push_back(boost::asio::buffer(batched.data(), batched.size()));
+        }
+    }
     
-    // Send the packet
+    // Send the whole batch with one write
     boost::asio::async_write(
         m_socket,
-        boost::asio::buffer(buffer),
+        m_writeBuffers,
         [self = shared_from_this()](const boost::system::error_code& error, size_t bytesTransferred) {
             self->handleSend(error, bytesTransferred);
         }
@@ -378,70 +558,220 @@ void ClientSession::handleSend(const boost::system::error_code& error, size_t by
             error != boost::asio::error::eof) {
             std::cerr << "Send error: " << error.message() << std::endl;
         }
+        m_sending = false;
         close();
         return;
     }
     
-    // Remove the sent packet from the queue
-    m_sendQueue.pop();
-    
-    // Continue sending if there are more packets
-    if (!m_sendQueue.empty()) {
-        startSend();
-    } else {
+    // Release the sent batch
+    m_queuedBytes.fetch_sub(m_writeBatchBytes, std::memory_order_relaxed);
+    m_queuedFrames.fetch_sub(m_writeBatchFrames, std::memory_order_relaxed);
+    m_server->getMetrics().bytesSent.fetch_add(bytesTransferred, std::memory_order_relaxed);
+    m_writeBatch.clear();
+    m_coalescedBytes.clear();
+    
+    // In coalescing mode frames queued during the write wait for the next
+    // flushSends(), unless a flush already came in or this batch was cut
+    // short by its size cap; otherwise continue with anything queued
+    if (m_coalesceSends && !m_flushRequested && !m_batchFull) {
         m_sending = false;
+        return;
     }
+    m_flushRequested = false;
+    startSend();
 }
 
-void ClientSession::sendChunkedWorldState() {
-    if (!m_server || !m_player) {
+void ClientSession::streamChunks() {
+    if (!m_player || !m_connected.load()) {
         return;
     }
     
-    World* world = m_server->getWorld();
-    if (!world) {
+    const int chunkSize = m_server->getWorld()->getChunkSize();
+    
+    // Crossing a chunk border requeues the view around the new chunk
+    m_unloadedChunks.clear();
+    m_chunkStreamer.setCenter(floorDiv(m_player->getX(), chunkSize),
+                              floorDiv(m_player->getY(), chunkSize),
+                              m_unloadedChunks);
+    for (const ChunkCoord& chunk : m_unloadedChunks) {
+        sendPacket(ChunkUnloadPacket(chunk.x * chunkSize, chunk.y * chunkSize, chunkSize, chunkSize));
+    }
+    
+    // Predict where the player will be and look ahead from there, trusting
+    // the reported speed only up to a few times the nominal one and keeping
+    // the point inside the world before it goes back to int. The horizon is
+    // how long a chunk asked for now takes to be in use: a round trip (the
+    // move reaching us, the chunk reaching the client) plus a fixed lead.
+    static constexpr float PREFETCH_LEAD_SECONDS = 0.5f;
+    static constexpr float MAX_SPEED_FACTOR = 4.0f;
+    const float horizon = PREFETCH_LEAD_SECONDS + m_roundTripSeconds;
+    const World* world = m_server->getWorld();
+    float vx = 0.0f;
+    float vy = 0.0f;
+    int aheadX = m_player->getX();
+    int aheadY = m_player->getY();
+    if (m_motion.estimateVelocity(vx, vy, MAX_SPEED_FACTOR * m_server->getConfig().playerMoveSpeed)) {
+        float maxX = static_cast<float>(std::max(0, world->getWidth() - 1));
+        float maxY = static_cast<float>(std::max(0, world->getHeight() - 1));
+        aheadX = static_cast<int>(std::clamp(aheadX + vx * horizon, 0.0f, maxX));
+        aheadY = static_cast<int>(std::clamp(aheadY + vy * horizon, 0.0f, maxY));
+    }
+    m_chunkStreamer.setPrefetchCenter(floorDiv(aheadX, chunkSize), floorDiv(aheadY, chunkSize));
+    
+    // A client that is already behind gets no more chunks until it catches up
+    if (m_overBudget) {
         return;
     }
     
-    // Player position
-    int playerX = m_player->getX();
-    int playerY = m_player->getY();
+    // Nearest chunks first, at least one per tick
+    size_t budget = m_server->getConfig().chunkStreamBytesPerTick;
+    size_t sent = 0;
+    ChunkCoord chunk;
+    while (sent < budget && m_chunkStreamer.popNext(chunk)) {
+        sent += sendChunk(chunk);
+    }
     
-    // Send chunks centered around the player
-    const int CHUNK_SIZE = 16;
-    const int VIEW_DISTANCE = 3; // Number of chunks in each direction
+    // Whatever budget the view left over goes to prefetching, as long as
+    // the socket is keeping up
+    if (m_queuedBytes.load() > budget) {
+        return;
+    }
+    while (sent < budget && m_chunkStreamer.popNextPrefetch(chunk)) {
+        sent += sendChunk(chunk);
+    }
+}
+
+size_t ClientSession::sendChunk(const ChunkCoord& chunk) {
+    // Shared with every other client streaming this chunk
+    FramedBuffer frame = m_server->getChunkFrame(chunk, m_compressedChunks);
+    if (frame.empty()) {
+        return 0;
+    }
+    sendFrame(frame);
+    return frame.size();
+}
+
+void ClientSession::updateKnownEntities(const std::vector<uint32_t>& visible,
+                                        std::vector<uint32_t>& entered, std::vector<uint32_t>& left) {
+    entered.clear();
+    left.clear();
+    
+    // Both lists are sorted, so the difference is a single merge pass
+    std::lock_guard<std::mutex> lock(m_knownEntitiesMutex);
+    std::set_difference(visible.begin(), visible.end(),
+                        m_knownEntities.begin(), m_knownEntities.end(),
+                        std::back_inserter(entered));
+    std::set_difference(m_knownEntities.begin(), m_knownEntities.end(),
+                        visible.begin(), visible.end(),
+                        std::back_inserter(left));
+    m_knownEntities = visible;
+}
+
+bool ClientSession::knowsEntity(uint32_t entityId) const {
+    std::lock_guard<std::mutex> lock(m_knownEntitiesMutex);
+    return std::binary_search(m_knownEntities.begin(), m_knownEntities.end(), entityId);
+}
+
+bool ClientSession::forgetEntity(uint32_t entityId) {
+    std::lock_guard<std::mutex> lock(m_knownEntitiesMutex);
+    auto it = std::lower_bound(m_knownEntities.begin(), m_knownEntities.end(), entityId);
+    if (it == m_knownEntities.end() || *it != entityId) {
+        return false;
+    }
+    m_knownEntities.erase(it);
+    return true;
+}
+
+void ClientSession::sendSnapshot(uint32_t tick, const SnapshotState& state) {
+    static const SnapshotState EMPTY_STATE;
     
-    for (int cy = -VIEW_DISTANCE; cy <= VIEW_DISTANCE; ++cy) {
-        for (int cx = -VIEW_DISTANCE; cx <= VIEW_DISTANCE; ++cx) {
-            // Calculate chunk coordinates
-            int chunkX = (playerX / CHUNK_SIZE + cx) * CHUNK_SIZE;
-            int chunkY = (playerY / CHUNK_SIZE + cy) * CHUNK_SIZE;
-            
-            // Create world chunk packet
-            WorldChunkPacket chunkPacket(chunkX, chunkY, CHUNK_SIZE, CHUNK_SIZE);
-            std::vector<uint8_t> tileData;
-            
-            // Fill tile data
-            for (int y = 0; y < CHUNK_SIZE; ++y) {
-                for (int x = 0; x < CHUNK_SIZE; ++x) {
-                    int worldX = chunkX + x;
-                    int worldY = chunkY + y;
-                    
-                    Tile tile = world->getTile(worldX, worldY);
-                    tileData.push_back(static_cast<uint8_t>(tile.type));
-                }
-            }
-            
-            chunkPacket.setTileData(tileData);
-            sendPacket(chunkPacket);
-        }
+    if (!m_connected.load()) {
+        return;
+    }
+    
+    // Unacknowledged snapshots may have been lost, so an unchanged state is
+    // sent again now and then until the client acknowledges it
+    static constexpr uint32_t RESEND_INTERVAL_TICKS = 10;
+    
+    // Snapshots sent over UDP that go unacknowledged this long mean the path
+    // is dead (NAT rebinding, firewall change); from then on they use TCP
+    static constexpr uint32_t UDP_ACK_TIMEOUT_TICKS = 40;
+    
+    uint32_t acked = m_ackedSnapshotTick.load();
+    bool outstanding = m_lastSnapshotTick != 0 && acked != m_lastSnapshotTick;
+    if (acked != m_lastSeenAck && acked != 0) {
+        // A new ack shows up at most a tick after it arrived; smooth the
+        // samples so one slow ack doesn't swing the prefetch horizon
+        float sample = static_cast<float>(tick - acked) / static_cast<float>(m_server->getConfig().tickRate);
+        m_roundTripSeconds += (sample - m_roundTripSeconds) * 0.125f;
+    }
+    if (!outstanding || acked != m_lastSeenAck) {
+        m_lastSeenAck = acked;
+        m_ackProgressTick = tick;
+    }
+    bool fallBack = m_udpSnapshots && m_lastSnapshotUnreliable && tick - m_ackProgressTick >= UDP_ACK_TIMEOUT_TICKS;
+    if (fallBack) {
+        m_udpSnapshots = false;
+        std::cout << "No snapshot acks over UDP for " << (tick - m_ackProgressTick)
+                  << " ticks; client " << m_playerId << " gets snapshots over TCP" << std::endl;
+    }
+    
+    const SnapshotState* lastSent = m_sentSnapshots.find(m_lastSnapshotTick);
+    bool unchanged = lastSent ? *lastSent == state : state.empty();
+    if (!fallBack && unchanged && (m_lastSnapshotTick == acked || tick - m_lastSnapshotTick < RESEND_INTERVAL_TICKS)) {
+        return;
+    }
+    
+    // Delta against the acknowledged snapshot if both sides still have it,
+    // otherwise send everything
+    const SnapshotState* baseline = nullptr;
+    if (acked != 0 && m_lastSnapshotTick - acked < SnapshotHistory::CAPACITY) {
+        baseline = m_sentSnapshots.find(acked);
+    }
+    
+    SnapshotPacket packet(tick, baseline ? acked : 0);
+    encodeSnapshotDelta(baseline ? *baseline : EMPTY_STATE, state, packet.getDeltaData());
+    
+    m_sentSnapshots.store(tick, state);
+    m_lastSnapshotTick = tick;
+    
+    // Every snapshot is complete relative to an acknowledged one, so losing
+    // a datagram or replacing an unsent TCP snapshot loses nothing
+    FramedBuffer frame = FramedBuffer::fromPacket(packet);
+    bool fitsDatagram = frame.packetSize() + DATAGRAM_HEADER_SIZE <= MAX_DATAGRAM_SIZE;
+    m_lastSnapshotUnreliable = m_udpSnapshots && fitsDatagram && sendUnreliable(frame.packetData(), frame.packetSize());
+    if (!m_lastSnapshotUnreliable) {
+        sendSupersedingFrame(supersedeKey(PacketType::SNAPSHOT, 0), frame);
     }
 }
 
-void ClientSession::handleConnectRequest(const ConnectRequestPacket& packet) {
+void ClientSession::handleSnapshotAck(const SnapshotAckView& packet) {
+    // Acks may arrive out of order; keep the newest
+    uint32_t tick = packet.getTick();
+    if (isNewerSequence(tick, m_ackedSnapshotTick.load())) {
+        m_ackedSnapshotTick.store(tick);
+    }
+}
+
+void ClientSession::offerUdpChannel() {
+    UdpChannel* channel = m_server->getUdpChannel();
+    if (!channel || m_udpToken != 0) {
+        return;
+    }
+    
+    // Positions keep going over TCP until the client answers with a UDP hello
+    m_udpToken = channel->registerSession(shared_from_this());
+    sendPacket(UdpOfferPacket(channel->getPort(), m_udpToken));
+}
+
+void ClientSession::handleConnectRequest(const ConnectRequestView& packet) {
     // Assign a player ID
     m_playerId = m_server->getNextPlayerId();
-    m_playerName = packet.getPlayerName();
+    m_playerName = std::string(packet.getPlayerName());
+    
+    // Use the compact chunk encoding if both sides support it
+    m_compressedChunks = m_server->getConfig().compressChunks &&
+                         (packet.getCapabilities() & CAPABILITY_COMPRESSED_CHUNKS) != 0;
     
     std::cout << "Player connected: " << m_playerName << " (ID: " << m_playerId << ")" << std::endl;
     
@@ -450,78 +780,33 @@ void ClientSession::handleConnectRequest(const ConnectRequestPacket& packet) {
     m_player->setId(m_playerId);
     m_player->setName(m_playerName);
     
-    // Place player in the world - THIS ADDS THE PLAYER AND BROADCASTS POSITION
-    m_server->addPlayer(m_playerId, m_player);
+    // Place player in the world
+    m_server->addPlayer(m_player);
     
     // Send connection accepted packet
     ConnectAcceptPacket acceptPacket(m_playerId);
     sendPacket(acceptPacket);
+    offerUdpChannel();
     
-    // FIRST, send player appearance packet to the new player for themselves
-    SDL_Color color = m_player->getColor();
+    // Send player appearance packet to the new player for themselves
+    Color color = m_player->getColor();
     PlayerAppearancePacket selfAppearancePacket(m_playerId, m_player->getSymbol(), 
                                            color.r, color.g, color.b, 
                                            m_playerName);
     sendPacket(selfAppearancePacket);
     
-    // THEN send the appearance to all other players
-    {
-        std::lock_guard<std::mutex> lock(m_server->getClientsMutex());
-        for (const auto& pair : m_server->getClients()) {
-            if (pair.first != m_playerId) {
-                PlayerAppearancePacket newPlayerPacket(m_playerId, m_player->getSymbol(),
-                                                    color.r, color.g, color.b,
-                                                    m_playerName);
-                pair.second->sendPacket(newPlayerPacket);
-                
-                // Also send each existing player's appearance to the new player
-                auto otherPlayer = pair.second->getPlayer();
-                if (otherPlayer) {
-                    SDL_Color otherColor = otherPlayer->getColor();
-                    PlayerAppearancePacket otherAppearancePacket(
-                        otherPlayer->getId(), 
-                        otherPlayer->getSymbol(),
-                        otherColor.r, otherColor.g, otherColor.b,
-                        otherPlayer->getName()
-                    );
-                    sendPacket(otherAppearancePacket);
-                }
-            }
-        }
-    }
-    
-    // IMPORTANT: First register this client in the server's client map
-    // Otherwise other clients won't see it in the client map when they try to send player list
+    // Register this client in the server's client map. Nearby players are
+    // spawned on both sides by the next visibility update, so joining costs
+    // nothing for players out of view
     {
         std::lock_guard<std::mutex> lock(m_server->getClientsMutex());
         m_server->getClients()[m_playerId] = shared_from_this();
     }
     
-    // Send existing players position info to the new player
-    PlayerListPacket playerListPacket;
-    std::lock_guard<std::mutex> lock(m_server->getClientsMutex());
-    for (const auto& pair : m_server->getClients()) {
-        if (pair.first != m_playerId) {
-            auto otherPlayer = pair.second->getPlayer();
-            if (otherPlayer) {
-                playerListPacket.addPlayer(otherPlayer->getId(), 
-                                          otherPlayer->getName(),
-                                          otherPlayer->getX(), 
-                                          otherPlayer->getY());
-            }
-        }
-    }
-    
-    // Send the player list to the new player
-    if (!playerListPacket.getPlayers().empty()) {
-        sendPacket(playerListPacket);
-    }
-    
-    // Send initial world state
-    sendChunkedWorldState();
+    // The world around the player streams in from the next tick on, see streamChunks()
 }
 
-void ClientSession::handlePlayerPosition(const PlayerPositionPacket& packet) {
+void ClientSession::handlePlayerPosition(const PlayerPositionView& packet) {
     if (!m_player) {
         return;
     }
@@ -532,20 +817,52 @@ void ClientSession::handlePlayerPosition(const PlayerPositionPacket& packet) {
         return;
     }
     
-    // Update player position
+    // Positions outside the world can't be legitimate, and everything
+    // derived from them (collision, view, prefetch) assumes they're inside
+    const World* world = m_server->getWorld();
+    if (packet.getX() < 0 || packet.getY() < 0 ||
+        packet.getX() >= world->getWidth() || packet.getY() >= world->getHeight()) {
+        std::cerr << "Player " << m_playerId << " reported a position outside the world: "
+                  << packet.getX() << "," << packet.getY() << std::endl;
+        return;
+    }
+    
+    // Update player position; other clients get it in their next snapshot
     m_player->setPosition(packet.getX(), packet.getY());
+    m_motion.addSample(packet.getX(), packet.getY());
+}
+
+void ClientSession::handlePlayerAppearance(const PlayerAppearanceView& packet) {
+    // Update the player's appearance
+    if (m_player) {
+        Color color = {
+            packet.getColorR(),
+            packet.getColorG(),
+            packet.getColorB(),
+            255
+        };
+        m_player->setColor(color);
+        m_player->setSymbol(packet.getSymbol());
+    }
     
-    // Broadcast to other clients
-    m_server->broadcastPlayerPosition(m_playerId, packet.getX(), packet.getY());
+    // Forward the received bytes as-is to the clients that know this player;
+    // the others get the new appearance in their spawn
+    if (m_player) {
+        FramedBuffer frame = FramedBuffer::fromRawData(packet.data(), packet.size());
+        m_server->broadcastPlayerAppearance(m_playerId, m_player->getX(), m_player->getY(), frame);
+    }
 }
 
-void ClientSession::handleWorldModification(const WorldModificationPacket& packet) {
+void ClientSession::handleWorldModification(const WorldModificationView& packet) {
     if (!m_player) {
         return;
     }
     
-    // Get tile type
-    TileType tileType = static_cast<TileType>(packet.getTileType());
+    // Tiles are stored as their type id; an unknown id would reach every client
+    if (!isValidTileType(packet.getTileType())) {
+        std::cerr << "Rejected unknown tile type from player " << m_playerId << std::endl;
+        return;
+    }
     
     // Get player position
     int playerX = m_player->getX();
@@ -557,10 +874,32 @@ void ClientSession::handleWorldModification(const WorldModificationPacket& packe
     float distance = std::sqrt(dx * dx + dy * dy);
     
     if (distance <= m_server->getConfig().playerInteractRange) {
-        // Modify the world
-        m_server->getWorld()->setTile(packet.getX(), packet.getY(), tileType);
-        
-        // Broadcast to ALL clients including the sender
-        m_server->broadcastWorldModification(packet.getX(), packet.getY(), packet.getTileType());
+        // Applied and broadcast with the rest of this tick's edits; the
+        // sender gets the delta too, correcting its local prediction
+        m_server->recordWorldModification(packet.getX(), packet.getY(), packet.getTileType());
+    }
+}
+
+void ClientSession::handleRegionEdit(const RegionEditView& packet) {
+    if (!m_player) {
+        return;
+    }
+    
+    RegionMask mask;
+    if (!isValidTileType(packet.getTileType()) || !packet.rasterize(mask)) {
+        std::cerr << "Rejected malformed region edit from player " << m_playerId << std::endl;
+        return;
+    }
+    
+    // The player has to reach the region: its nearest tile must be in range.
+    // Corners can be anywhere, so measure in 64 bits
+    int64_t playerX = m_player->getX();
+    int64_t playerY = m_player->getY();
+    int64_t dx = std::max<int64_t>({mask.x - playerX, 0, playerX - (static_cast<int64_t>(mask.x) + mask.width - 1)});
+    int64_t dy = std::max<int64_t>({mask.y - playerY, 0, playerY - (static_cast<int64_t>(mask.y) + mask.height - 1)});
+    double distance = std::sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy);
+    
+    if (distance <= m_server->getConfig().playerInteractRange) {
+        m_server->recordRegionEdit(mask, packet.getTileType());
     }
 }
\ No newline at end of file
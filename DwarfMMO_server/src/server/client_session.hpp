@@ -2,13 +2,24 @@
 
 #include <memory>
 #include <boost/asio.hpp>
-#include <queue>
 #include <vector>
+#include <array>
 #include <atomic>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
 #include "network/packet.hpp"
+#include "network/framed_buffer.hpp"
+#include "network/receive_buffer.hpp"
+#include "server/mpsc_queue.hpp"
+#include "network/datagram.hpp"
+#include "network/snapshot.hpp"
+#include "server/chunk_streamer.hpp"
+#include "server/motion_tracker.hpp"
 #include "game/player.hpp"
 
 using boost::asio::ip::tcp;
+using boost::asio::ip::udp;
 
 // Forward declarations
 class Server;
@@ -31,6 +42,58 @@ public:
     // Send a packet to the client
     void sendPacket(const Packet& packet);
     
+    // Send an already framed packet (shared between broadcast recipients)
+    void sendFrame(const FramedBuffer& frame);
+    
+    // Send a state update that replaces any still-queued update with the same
+    // key. Ordering rule: each write sends the ordered queue first and the
+    // superseding updates after it, so an update can reach the client after
+    // ordered frames queued later than it (a despawn next tick, say). Callers
+    // must not rely on an update arriving before a later ordered frame; when
+    // that frame makes the update wrong, cancel the update before queuing it.
+    void sendSupersedingFrame(uint64_t key, const FramedBuffer& frame);
+    
+    // Write everything queued so far (end of tick in coalescing mode)
+    void flushSends();
+    
+    // Drop the queued superseding update with this key, if any
+    void cancelSupersedingFrame(uint64_t key);
+    
+    // Key identifying the latest state of one entity for one packet type
+    static uint64_t supersedeKey(PacketType type, uint32_t entityId) {
+        return (static_cast<uint64_t>(type) << 32) | entityId;
+    }
+    
+    // Send packet bytes over the UDP side channel; false if the client has none
+    bool sendUnreliable(const uint8_t* packet, size_t size);
+    
+    // Called by the UDP channel once the client proved its endpoint
+    void bindUdpEndpoint(const udp::endpoint& endpoint);
+    
+    // Called by the UDP channel for each datagram from this client's endpoint
+    void receiveDatagram(uint32_t sequence, const uint8_t* packet, size_t size);
+    
+    // Replace the set of entities this client knows about with the sorted
+    // visible set, reporting which ids entered and which left
+    void updateKnownEntities(const std::vector<uint32_t>& visible,
+                             std::vector<uint32_t>& entered, std::vector<uint32_t>& left);
+    
+    // True if the client has been told about the entity
+    bool knowsEntity(uint32_t entityId) const;
+    
+    // Drop an entity from the known set; true if it was known
+    bool forgetEntity(uint32_t entityId);
+    
+    // Send the positions this client sees at a tick, as a delta against the
+    // newest snapshot it acknowledged (game thread)
+    void sendSnapshot(uint32_t tick, const SnapshotState& state);
+    
+    // True if the chunk has been sent to the client and not unloaded since (game thread)
+    bool hasChunkLoaded(const ChunkCoord& chunk) const { return m_chunkStreamer.isLoaded(chunk); }
+    
+    // True while the send backlog exceeds the configured budget
+    bool isOverBudget() const { return m_overBudget; }
+    
     // Process a single game update tick
     void update(float deltaTime);
     
@@ -55,38 +118,137 @@ private:
     std::string m_playerName;
     std::shared_ptr<Player> m_player;
     
-    // Receive buffer
-    std::vector<uint8_t> m_receiveBuffer;
-    uint32_t m_expectedLength;
+    // Receive ring, filled by async_read_some
+    ReceiveBuffer m_receiveBuffer;
     
-    // Send queue
-    std::queue<std::vector<uint8_t>> m_sendQueue;
+    // Outbound queue, filled from any thread and drained on the IO thread
+    MpscQueue<FramedBuffer> m_sendQueue;
+    std::atomic<bool> m_flushScheduled;
+    
+    // When set, queued frames wait for flushSends() and go out as one buffer
+    const bool m_coalesceSends;
+    
+    // Batch currently being written (only touched on this session's IO thread)
+    std::vector<FramedBuffer> m_writeBatch;
+    std::vector<uint8_t> m_coalescedBytes;
+    std::vector<boost::asio::const_buffer> m_writeBuffers;
+    size_t m_writeBatchBytes;
+    size_t m_writeBatchFrames;
     bool m_sending;
     
+    // Coalescing mode: a flush arrived while a write was in flight, or the
+    // last batch hit its size cap with frames left over
+    bool m_flushRequested;
+    bool m_batchFull;
+    
+    // Latest queued update per (packet type, entity); sent after the ordered
+    // queue (see sendSupersedingFrame)
+    std::mutex m_supersedeMutex;
+    std::unordered_map<uint64_t, FramedBuffer> m_supersedingFrames;
+    
+    // Backlog accounting: frames/bytes queued but not yet written
+    std::atomic<size_t> m_queuedBytes;
+    std::atomic<size_t> m_queuedFrames;
+    
+    // Slow consumer tracking (game thread only)
+    bool m_overBudget;
+    std::chrono::steady_clock::time_point m_overBudgetSince;
+    
+    // Set when the socket can't keep up, so close() doesn't block on it
+    std::atomic<bool> m_sendStalled;
+    
+    // UDP side channel: token offered over TCP, endpoint once the client said hello
+    uint32_t m_udpToken;
+    udp::endpoint m_udpEndpoint;
+    std::atomic<bool> m_udpBound;
+    std::atomic<uint32_t> m_udpSendSequence;
+    SequenceFilter m_udpReceiveFilter;
+    
+    // Entities this client has been sent a spawn for (sorted ids)
+    mutable std::mutex m_knownEntitiesMutex;
+    std::vector<uint32_t> m_knownEntities;
+    
+    // Snapshots sent (game thread) and the newest one the client acknowledged
+    SnapshotHistory m_sentSnapshots;
+    uint32_t m_lastSnapshotTick;
+    std::atomic<uint32_t> m_ackedSnapshotTick;
+    
+    // UDP snapshot health (game thread): the newest ack seen, the tick it
+    // last advanced (or nothing was outstanding), and whether snapshots
+    // still go over UDP at all
+    uint32_t m_lastSeenAck;
+    uint32_t m_ackProgressTick;
+    bool m_lastSnapshotUnreliable;
+    bool m_udpSnapshots;
+    
     // Start receiving data
     void startReceive();
 
-    void sendChunkedWorldState();
+    // Whether chunks go out as CompressedChunk; fixed by the connect request
+    // before the session is registered with the game thread
+    bool m_compressedChunks;
+    
+    // Chunks loaded on the client and still to send (game thread only)
+    ChunkStreamer m_chunkStreamer;
+    std::vector<ChunkCoord> m_unloadedChunks;
+    
+    // Recent reported positions, for prefetching chunks ahead of the player
+    MotionTracker m_motion;
+    
+    // Smoothed time from sending a snapshot to seeing its ack (game thread),
+    // which is how long a move takes to be answered with chunks
+    float m_roundTripSeconds;
+    
+    // Follow the player with the loaded chunk set, sending up to the per-tick
+    // budget; leftover budget prefetches chunks ahead of the player and
+    // around the view
+    void streamChunks();
     
-    // Handle received header
-    void handleReceiveHeader(const boost::system::error_code& error, size_t bytesTransferred);
+    // Send one chunk's tiles; returns the bytes queued
+    size_t sendChunk(const ChunkCoord& chunk);
     
-    // Handle received body
-    void handleReceiveBody(const boost::system::error_code& error, size_t bytesTransferred);
+    // Offer the client a UDP side channel, if the server has one
+    void offerUdpChannel();
+    
+    // Handle received bytes, processing every complete frame
+    void handleReceive(const boost::system::error_code& error, size_t bytesTransferred);
     
     // Process received packet
     void processPacket(const uint8_t* data, size_t size);
     
-    // Start sending queued packets
+    // Wake the IO thread to flush the send queue
+    void scheduleFlush();
+    
+    // Drain the send queue into a single gathered write
     void startSend();
     
+    // Batch building helpers for startSend()
+    bool batchHasRoom() const;
+    void addToBatch(FramedBuffer frame);
+    
+    // Track the backlog against the budget; disconnect after the grace period
+    void checkBackpressure();
+    
     // Handle send completion
     void handleSend(const boost::system::error_code& error, size_t bytesTransferred);
     
+    // Packet dispatch: one entry per PacketType, null for packets clients can't send
+    using PacketHandler = void (ClientSession::*)(const uint8_t* data, size_t size);
+    using PacketHandlerTable = std::array<PacketHandler, PACKET_TYPE_COUNT>;
+    static constexpr PacketHandlerTable makePacketHandlers();
+    
+    // Bind a view over the packet bytes and forward it to a typed handler
+    template<typename View, void (ClientSession::*Handler)(const View&)>
+    void dispatchView(const uint8_t* data, size_t size);
+    
     // Packet handlers
-    void handleConnectRequest(const ConnectRequestPacket& packet);
-    void handlePlayerPosition(const PlayerPositionPacket& packet);
-    void handleWorldModification(const WorldModificationPacket& packet);
+    void handleConnectRequest(const ConnectRequestView& packet);
+    void handlePlayerPosition(const PlayerPositionView& packet);
+    void handlePlayerAppearance(const PlayerAppearanceView& packet);
+    void handleWorldModification(const WorldModificationView& packet);
+    void handleRegionEdit(const RegionEditView& packet);
+    void handleSnapshotAck(const SnapshotAckView& packet);
+    void ignorePacket(const uint8_t* data, size_t size);
 };
 
 using ClientSessionPtr = std::shared_ptr<ClientSession>;
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "server/config.hpp"
+#include "network/packet.hpp"
 #include <fstream>
 #include <iostream>
 
@@ -39,6 +40,14 @@ bool ServerConfig::loadFromFile(const std::string& filename) {
                     maxClients = static_cast<uint32_t>(std::stoi(value));
                 } else if (key == "tickRate") {
                     tickRate = static_cast<uint32_t>(std::stoi(value));
+                } else if (key == "ioThreads") {
+                    ioThreads = static_cast<uint32_t>(std::stoi(value));
+                } else if (key == "pendingAccepts") {
+                    pendingAccepts = static_cast<uint32_t>(std::stoi(value));
+                } else if (key == "udpEnabled") {
+                    udpEnabled = (value == "true" || value == "1");
+                } else if (key == "udpPort") {
+                    udpPort = static_cast<uint16_t>(std::stoi(value));
                 } else if (key == "worldWidth") {
                     worldWidth = std::stoi(value);
                 } else if (key == "worldHeight") {
@@ -55,11 +64,28 @@ bool ServerConfig::loadFromFile(const std::string& filename) {
                     maxUpdatesPerTick = static_cast<uint32_t>(std::stoi(value));
                 } else if (key == "chunkSize") {
                     chunkSize = static_cast<uint32_t>(std::stoi(value));
+                } else if (key == "viewRadiusChunks") {
+                    viewRadiusChunks = static_cast<uint32_t>(std::stoi(value));
+                } else if (key == "chunkStreamBytesPerTick") {
+                    chunkStreamBytesPerTick = static_cast<uint32_t>(std::stoul(value));
+                } else if (key == "compressChunks") {
+                    compressChunks = (value == "true" || value == "1");
+                } else if (key == "coalesceSends") {
+                    coalesceSends = (value == "true" || value == "1");
+                } else if (key == "sendBudgetBytes") {
+                    sendBudgetBytes = static_cast<uint32_t>(std::stoul(value));
+                } else if (key == "sendQueueHighWater") {
+                    sendQueueHighWater = static_cast<uint32_t>(std::stoul(value));
+                } else if (key == "slowConsumerGraceMs") {
+                    slowConsumerGraceMs = static_cast<uint32_t>(std::stoul(value));
+                } else if (key == "metricsIntervalSeconds") {
+                    metricsIntervalSeconds = static_cast<uint32_t>(std::stoul(value));
                 }
             }
         }
         
         file.close();
+        validate();
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Error loading config: " << e.what() << std::endl;
@@ -67,6 +93,18 @@ bool ServerConfig::loadFromFile(const std::string& filename) {
     }
 }
 
+void ServerConfig::validate() {
+    // Chunk coordinates divide by the chunk size, and clients reject chunk
+    // packets wider than MAX_CHUNK_SIDE
+    uint32_t maxChunkSize = static_cast<uint32_t>(MAX_CHUNK_SIDE);
+    if (chunkSize < 1 || chunkSize > maxChunkSize) {
+        uint32_t clamped = chunkSize < 1 ? 1 : maxChunkSize;
+        std::cerr << "chunkSize " << chunkSize << " is outside 1.." << maxChunkSize
+                  << "; using " << clamped << std::endl;
+        chunkSize = clamped;
+    }
+}
+
 bool ServerConfig::saveToFile(const std::string& filename) const {
     try {
         std::ofstream file(filename);
@@ -81,7 +119,11 @@ bool ServerConfig::saveToFile(const std::string& filename) const {
         file << "# Network settings\n";
         file << "port=" << port << "\n";
         file << "maxClients=" << maxClients << "\n";
-        file << "tickRate=" << tickRate << "\n\n";
+        file << "tickRate=" << tickRate << "\n";
+        file << "ioThreads=" << ioThreads << "\n";
+        file << "pendingAccepts=" << pendingAccepts << "\n";
+        file << "udpEnabled=" << (udpEnabled ? "true" : "false") << "\n";
+        file << "udpPort=" << udpPort << "\n\n";
         
         // World settings
         file << "# World settings\n";
@@ -99,6 +141,17 @@ bool ServerConfig::saveToFile(const std::string& filename) const {
         file << "# Performance settings\n";
         file << "maxUpdatesPerTick=" << maxUpdatesPerTick << "\n";
         file << "chunkSize=" << chunkSize << "\n";
+        file << "viewRadiusChunks=" << viewRadiusChunks << "\n";
+        file << "chunkStreamBytesPerTick=" << chunkStreamBytesPerTick << "\n";
+        file << "compressChunks=" << (compressChunks ? "true" : "false") << "\n";
+        file << "coalesceSends=" << (coalesceSends ? "true" : "false") << "\n\n";
+        
+        // Backpressure settings
+        file << "# Backpressure settings\n";
+        file << "sendBudgetBytes=" << sendBudgetBytes << "\n";
+        file << "sendQueueHighWater=" << sendQueueHighWater << "\n";
+        file << "slowConsumerGraceMs=" << slowConsumerGraceMs << "\n";
+        file << "metricsIntervalSeconds=" << metricsIntervalSeconds << "\n";
         
         file.close();
         return true;
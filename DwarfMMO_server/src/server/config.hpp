@@ -8,6 +8,10 @@ struct ServerConfig {
     uint16_t port = 7777;
     uint32_t maxClients = 100;
     uint32_t tickRate = 20;  // Updates per second
+    uint32_t ioThreads = 0;  // 0 = one per hardware thread
+    uint32_t pendingAccepts = 4;  // Accepts kept outstanding on the listener
+    bool udpEnabled = true;  // Offer clients a UDP side channel for positions
+    uint16_t udpPort = 0;    // 0 = same number as the TCP port
     
     // World settings
     int worldWidth = 500;
@@ -22,10 +26,24 @@ struct ServerConfig {
     // Performance settings
     uint32_t maxUpdatesPerTick = 1000;
     uint32_t chunkSize = 16;
+    uint32_t viewRadiusChunks = 3;  // Chunks visible in each direction around a player
+    uint32_t chunkStreamBytesPerTick = 16 * 1024;  // Chunk data sent per client per tick
+    bool compressChunks = true;  // Send compressed chunks to clients that support them
+    bool coalesceSends = false;  // Hold outbound packets until the end of each tick
+    
+    // Backpressure settings (per client session)
+    uint32_t sendBudgetBytes = 1024 * 1024;  // Queued bytes before a client counts as slow
+    uint32_t sendQueueHighWater = 4096;      // Queued frames before a client counts as slow
+    uint32_t slowConsumerGraceMs = 5000;     // Time over budget before disconnecting
+    uint32_t metricsIntervalSeconds = 60;    // 0 = never print metrics
     
     // Load configuration from file
     bool loadFromFile(const std::string& filename);
     
+    // Bring settings the server relies on into range, warning about each
+    // one changed; loadFromFile does this itself
+    void validate();
+    
     // Save configuration to file
     bool saveToFile(const std::string& filename) const;
 };
\ No newline at end of file
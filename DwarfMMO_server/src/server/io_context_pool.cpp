@@ -0,0 +1,52 @@
+#include "server/io_context_pool.hpp"
+#include <iostream>
+
+IoContextPool::IoContextPool(size_t poolSize)
+    : m_nextContext(0) {
+
+    if (poolSize == 0) {
+        poolSize = 1;
+    }
+
+    // One io_context per thread, each kept alive by its own work guard
+    for (size_t i = 0; i < poolSize; ++i) {
+        m_ioContexts.push_back(std::make_unique<boost::asio::io_context>(1));
+        m_workGuards.push_back(boost::asio::make_work_guard(*m_ioContexts.back()));
+    }
+}
+
+IoContextPool::~IoContextPool() {
+    stop();
+}
+
+void IoContextPool::run() {
+    for (size_t i = 0; i < m_ioContexts.size(); ++i) {
+        boost::asio::io_context* ioContext = m_ioContexts[i].get();
+        m_threads.emplace_back([ioContext, i]() {
+            try {
+                ioContext->run();
+            } catch (const std::exception& e) {
+                std::cerr << "IO thread " << i << " error: " << e.what() << std::endl;
+            }
+        });
+    }
+
+    std::cout << "Started " << m_threads.size() << " IO thread(s)" << std::endl;
+}
+
+void IoContextPool::stop() {
+    // Allow each io_context to exit once its remaining handlers complete
+    m_workGuards.clear();
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_threads.clear();
+}
+
+boost::asio::io_context& IoContextPool::getIoContext() {
+    size_t index = m_nextContext.fetch_add(1, std::memory_order_relaxed) % m_ioContexts.size();
+    return *m_ioContexts[index];
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <boost/asio.hpp>
+
+// A pool of io_contexts, each run by exactly one thread.
+// Sessions are pinned to a single io_context for their lifetime, so all of a
+// session's handlers run on one thread and never need a strand.
+class IoContextPool {
+public:
+    explicit IoContextPool(size_t poolSize);
+    ~IoContextPool();
+
+    // Start one thread per io_context
+    void run();
+
+    // Release the work guards and wait for every thread to drain and exit
+    void stop();
+
+    // Get the next io_context in round-robin order
+    boost::asio::io_context& getIoContext();
+
+    // Get the io_context that owns the listening socket
+    boost::asio::io_context& getAcceptorContext() { return *m_ioContexts.front(); }
+
+    size_t size() const { return m_ioContexts.size(); }
+
+    // Disable copying
+    IoContextPool(const IoContextPool&) = delete;
+    IoContextPool& operator=(const IoContextPool&) = delete;
+
+private:
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+
+    std::vector<std::unique_ptr<boost::asio::io_context>> m_ioContexts;
+    std::vector<WorkGuard> m_workGuards;
+    std::vector<std::thread> m_threads;
+    std::atomic<size_t> m_nextContext;
+};
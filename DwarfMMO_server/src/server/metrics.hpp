@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// Server-wide counters, updated lock-free from the IO and game threads
+// and printed periodically by the game loop.
+struct ServerMetrics {
+    // Outbound traffic
+    std::atomic<uint64_t> framesQueued{0};
+    std::atomic<uint64_t> framesSuperseded{0};
+    std::atomic<uint64_t> bytesSent{0};
+
+    // Backpressure
+    std::atomic<uint64_t> peakQueuedBytes{0};
+    std::atomic<uint32_t> sessionsOverBudget{0};
+    std::atomic<uint64_t> slowConsumerDisconnects{0};
+
+    // Chunk frames handed out from the cache and ones that had to be encoded
+    std::atomic<uint64_t> chunkFramesCached{0};
+    std::atomic<uint64_t> chunkFramesEncoded{0};
+
+    // Raise the peak if queuedBytes exceeds it
+    void recordQueuedBytes(uint64_t queuedBytes) {
+        uint64_t peak = peakQueuedBytes.load(std::memory_order_relaxed);
+        while (queuedBytes > peak &&
+               !peakQueuedBytes.compare_exchange_weak(peak, queuedBytes, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Write a one-line summary
+    void print(std::ostream& out) const {
+        out << "Metrics: queued=" << framesQueued.load()
+            << " superseded=" << framesSuperseded.load()
+            << " sentBytes=" << bytesSent.load()
+            << " peakQueuedBytes=" << peakQueuedBytes.load()
+            << " overBudget=" << sessionsOverBudget.load()
+            << " slowDisconnects=" << slowConsumerDisconnects.load()
+            << " chunksCached=" << chunkFramesCached.load()
+            << " chunksEncoded=" << chunkFramesEncoded.load();
+    }
+};
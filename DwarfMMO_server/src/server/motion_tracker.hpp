@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+
+// Recent positions reported by one client, used to estimate where the player
+// is heading. Samples are added from the session's IO thread and read from
+// the game thread.
+class MotionTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    MotionTracker() : m_count(0), m_next(0) {
+    }
+
+    void addSample(int x, int y) { addSample(x, y, Clock::now()); }
+
+    // Explicit times are for replaying recorded or simulated movement
+    void addSample(int x, int y, Clock::time_point time) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_samples[m_next] = Sample{time, x, y};
+        m_next = (m_next + 1) % MAX_SAMPLES;
+        if (m_count < MAX_SAMPLES) {
+            ++m_count;
+        }
+    }
+
+    // Average velocity in tiles per second over the recent samples, scaled
+    // down to at most maxSpeed (positions come from the client and may be
+    // anything); false if the player hasn't reported a move lately or
+    // there's too little history
+    bool estimateVelocity(float& vx, float& vy, float maxSpeed) const {
+        return estimateVelocity(vx, vy, maxSpeed, Clock::now());
+    }
+
+    bool estimateVelocity(float& vx, float& vy, float maxSpeed, Clock::time_point now) const {
+        // Reports older than this mean the player stopped
+        static constexpr auto STOPPED_AFTER = std::chrono::milliseconds(500);
+        // Only samples this close to the newest one count
+        static constexpr auto WINDOW = std::chrono::milliseconds(1000);
+        // Shorter spans give noisy estimates
+        static constexpr auto MIN_SPAN = std::chrono::milliseconds(50);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count < 2) {
+            return false;
+        }
+
+        const Sample& newest = m_samples[(m_next + MAX_SAMPLES - 1) % MAX_SAMPLES];
+        if (now - newest.time > STOPPED_AFTER) {
+            return false;
+        }
+
+        // Oldest sample still inside the window
+        const Sample* oldest = &newest;
+        for (size_t i = 2; i <= m_count; ++i) {
+            const Sample& sample = m_samples[(m_next + MAX_SAMPLES - i) % MAX_SAMPLES];
+            if (newest.time - sample.time > WINDOW) {
+                break;
+            }
+            oldest = &sample;
+        }
+
+        auto span = newest.time - oldest->time;
+        if (span < MIN_SPAN) {
+            return false;
+        }
+
+        // Differences in double: far apart reports would overflow an int
+        double seconds = std::chrono::duration<double>(span).count();
+        double dx = (static_cast<double>(newest.x) - oldest->x) / seconds;
+        double dy = (static_cast<double>(newest.y) - oldest->y) / seconds;
+        double speed = std::sqrt(dx * dx + dy * dy);
+        if (speed > maxSpeed) {
+            double scale = speed > 0.0 ? std::max(0.0f, maxSpeed) / speed : 0.0;
+            dx *= scale;
+            dy *= scale;
+        }
+        vx = static_cast<float>(dx);
+        vy = static_cast<float>(dy);
+        return true;
+    }
+
+private:
+    struct Sample {
+        Clock::time_point time;
+        int x;
+        int y;
+    };
+
+    static constexpr size_t MAX_SAMPLES = 8;
+
+    mutable std::mutex m_mutex;
+    std::array<Sample, MAX_SAMPLES> m_samples;
+    size_t m_count;
+    size_t m_next;
+};
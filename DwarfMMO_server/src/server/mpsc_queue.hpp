@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// Unbounded lock-free multi-producer single-consumer queue.
+// Any thread may push; only the owning thread may pop. A push that is still in
+// progress can make pop() report an empty queue, so consumers must be woken
+// again after every push (ClientSession does this with its flush flag).
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue()
+        : m_head(new Node()),
+          m_tail(m_head.load(std::memory_order_relaxed)) {
+    }
+
+    ~MpscQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        delete m_tail;
+    }
+
+    // Push a value (safe from any thread)
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Pop the oldest value (consumer thread only)
+    bool pop(T& value) {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+
+        // The popped node becomes the new stub
+        value = std::move(next->value);
+        m_tail = next;
+        delete tail;
+        return true;
+    }
+
+    // Disable copying
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+private:
+    struct Node {
+        Node() : next(nullptr) {}
+        explicit Node(T v) : next(nullptr), value(std::move(v)) {}
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+};
@@ -3,19 +3,33 @@
 #include <iostream>
 #include <chrono>
 #include <future>
+#include <algorithm>
 
-Server::Server(boost::asio::io_context& ioContext, const ServerConfig& config)
-    : m_ioContext(ioContext),
+Server::Server(IoContextPool& ioPool, const ServerConfig& config)
+    : m_ioPool(ioPool),
       m_config(config),
       m_running(false),
-      m_acceptor(ioContext, tcp::endpoint(tcp::v4(), config.port)),
-      m_nextPlayerId(1) {
-    
-    // Create the game world
-    m_world = std::make_unique<World>(config.worldWidth, config.worldHeight);
+      m_acceptor(ioPool.getAcceptorContext(), tcp::endpoint(tcp::v4(), config.port)),
+      // The world clamps the chunk size; everything else takes it from there
+      m_world(std::make_unique<World>(config.worldWidth, config.worldHeight, static_cast<int>(config.chunkSize),
+                                      config.worldSeed)),
+      m_nextPlayerId(1),
+      m_worldEdits(m_world->getChunkSize(), config.worldWidth, config.worldHeight),
+      m_tickCount(0) {
+    m_chunkFrames = std::make_unique<ChunkFrameCache>(*m_world);
     
     // Configure acceptor
     m_acceptor.set_option(tcp::acceptor::reuse_address(true));
+    
+    // Optional UDP side channel; the server works without it
+    if (config.udpEnabled) {
+        uint16_t udpPort = config.udpPort != 0 ? config.udpPort : config.port;
+        try {
+            m_udpChannel = std::make_unique<UdpChannel>(ioPool.getAcceptorContext(), udpPort);
+        } catch (const std::exception& e) {
+            std::cerr << "UDP side channel disabled: " << e.what() << std::endl;
+        }
+    }
 }
 
 Server::~Server() {
@@ -29,8 +43,16 @@ void Server::start() {
     
     m_running = true;
     
-    // Start accepting connections
-    startAccept();
+    // Keep several accepts outstanding so connection bursts don't queue
+    // behind a single handler
+    uint32_t pendingAccepts = std::max<uint32_t>(1, m_config.pendingAccepts);
+    for (uint32_t i = 0; i < pendingAccepts; ++i) {
+        startAccept();
+    }
+    
+    if (m_udpChannel) {
+        m_udpChannel->start();
+    }
     
     // Start game loop in a separate thread
     m_gameThread = std::thread(&Server::gameLoop, this);
@@ -50,6 +72,10 @@ void Server::stop() {
     try {
         m_acceptor.close();
         std::cout << "Stopped accepting new connections" << std::endl;
+        
+        if (m_udpChannel) {
+            m_udpChannel->stop();
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error closing acceptor: " << e.what() << std::endl;
     }
@@ -127,12 +153,39 @@ void Server::tick() {
     
     // Update all clients
     std::lock_guard<std::mutex> lock(m_clientsMutex);
+    uint32_t overBudget = 0;
     for (auto& pair : m_clients) {
         pair.second->update(deltaTime);
+        if (pair.second->isOverBudget()) {
+            ++overBudget;
+        }
+    }
+    m_metrics.sessionsOverBudget.store(overBudget);
+    
+    // Tiles edited during the tick go out once, a delta per chunk
+    flushWorldEdits();
+    
+    // Spawn, despawn and snapshot the entities in each client's view
+    replicateToClients(static_cast<uint32_t>(m_tickCount + 1));
+    
+    // Everything this tick queued goes out in one write per client
+    if (m_config.coalesceSends) {
+        for (auto& pair : m_clients) {
+            pair.second->flushSends();
+        }
+    }
+    
+    // Print metrics periodically
+    ++m_tickCount;
+    uint64_t metricsTicks = static_cast<uint64_t>(m_config.metricsIntervalSeconds) * m_config.tickRate;
+    if (metricsTicks > 0 && m_tickCount % metricsTicks == 0) {
+        m_metrics.print(std::cout);
+        std::cout << " clients=" << m_clients.size()
+                  << " tileKB=" << m_world->getTileMemoryUsage() / 1024 << std::endl;
     }
 }
 
-void Server::addPlayer(uint32_t playerId, std::shared_ptr<Player> player) {
+void Server::addPlayer(std::shared_ptr<Player> player) {
     // Add player to the world
     m_world->addEntity(player);
     
@@ -140,24 +193,20 @@ void Server::addPlayer(uint32_t playerId, std::shared_ptr<Player> player) {
     int centerX = m_config.worldWidth / 2;
     int centerY = m_config.worldHeight / 2;
     
-    // Find an empty spot near the center
+    // Find an empty spot near the center, scanning each row of the square
+    // a word of the solidity layer at a time
     for (int radius = 0; radius < 10; ++radius) {
         for (int y = centerY - radius; y <= centerY + radius; ++y) {
-            for (int x = centerX - radius; x <= centerX + radius; ++x) {
-                if (!m_world->isSolid(x, y)) {
-                    player->setPosition(x, y);
-                    
-                    // Broadcast new player to all clients
-                    broadcastPlayerPosition(playerId, x, y);
-                    return;
-                }
+            int x = m_world->findFreeTileInRow(y, centerX - radius, centerX + radius + 1);
+            if (x >= 0) {
+                player->setPosition(x, y);
+                return;
             }
         }
     }
     
     // If no empty spot found, just place at center
     player->setPosition(centerX, centerY);
-    broadcastPlayerPosition(playerId, centerX, centerY);
 }
 
 void Server::removePlayer(uint32_t playerId) {
@@ -174,13 +223,17 @@ void Server::removePlayer(uint32_t playerId) {
         playerName = clientIt->second->getPlayer()->getName();
     }
     
-    // Create disconnect packet
-    DisconnectPacket packet(playerName);
+    // Create despawn packet, serialized once for every recipient
+    FramedBuffer frame = FramedBuffer::fromPacket(EntityDespawnPacket(playerId));
     
-    // Send to all clients except the disconnecting one
+    // Only clients that were shown the player need to hear it left; drop any
+    // still-queued appearance update first, since it would go out after the
+    // despawn
+    uint64_t appearanceKey = ClientSession::supersedeKey(PacketType::PLAYER_APPEARANCE, playerId);
     for (auto& pair : m_clients) {
-        if (pair.first != playerId) {
-            pair.second->sendPacket(packet);
+        if (pair.first != playerId && pair.second->forgetEntity(playerId)) {
+            pair.second->cancelSupersedingFrame(appearanceKey);
+            pair.second->sendFrame(frame);
         }
     }
     
@@ -202,27 +255,160 @@ const ServerConfig& Server::getConfig() const {
     return m_config;
 }
 
-void Server::broadcastPlayerPosition(uint32_t playerId, int x, int y) {
-    // Create player position packet
-    PlayerPositionPacket packet(playerId, x, y);
+void Server::broadcastPlayerAppearance(uint32_t playerId, int x, int y, const FramedBuffer& frame) {
+    EntitySpan viewers = getPlayersInView(x, y);
+    uint64_t key = ClientSession::supersedeKey(PacketType::PLAYER_APPEARANCE, playerId);
     
-    // Send to ALL clients, including the originating player
     std::lock_guard<std::mutex> lock(m_clientsMutex);
-    for (auto& pair : m_clients) {
-        // Send to everyone to ensure consistency
-        pair.second->sendPacket(packet);
+    for (const SpatialEntry& viewer : viewers) {
+        auto it = m_clients.find(static_cast<uint32_t>(viewer.id));
+        if (it != m_clients.end() && it->first != playerId && it->second->knowsEntity(playerId)) {
+            it->second->sendSupersedingFrame(key, frame);
+        }
     }
 }
 
-void Server::broadcastWorldModification(int x, int y, uint8_t tileType) {
-    // Create world modification packet
-    WorldModificationPacket packet(x, y, tileType);
+EntitySpan Server::getPlayersInView(int x, int y) const {
+    int chunkSize = m_world->getChunkSize();
+    int radius = static_cast<int>(m_config.viewRadiusChunks);
+    int chunkX = floorDiv(x, chunkSize);
+    int chunkY = floorDiv(y, chunkSize);
+    return m_world->getEntitiesInRect(
+        (chunkX - radius) * chunkSize, (chunkY - radius) * chunkSize,
+        (chunkX + radius + 1) * chunkSize - 1, (chunkY + radius + 1) * chunkSize - 1,
+        true);
+}
+
+void Server::replicateToClients(uint32_t tick) {
+    // Spawn frames are built once per tick and shared by every client that
+    // needs them; the despawn frame depends only on the id
+    std::unordered_map<uint32_t, FramedBuffer> spawnFrames;
     
-    // Send to all clients
-    std::lock_guard<std::mutex> lock(m_clientsMutex);
     for (auto& pair : m_clients) {
-        // Make sure to send to ALL clients, even the one that made the modification
-        pair.second->sendPacket(packet);
+        std::shared_ptr<Player> player = pair.second->getPlayer();
+        if (!player) {
+            continue;
+        }
+        
+        m_visibleState.clear();
+        for (const SpatialEntry& entry : getPlayersInView(player->getX(), player->getY())) {
+            uint32_t id = static_cast<uint32_t>(entry.id);
+            if (id != pair.first) {
+                m_visibleState.push_back(SnapshotEntity{id, entry.x, entry.y});
+            }
+        }
+        std::sort(m_visibleState.begin(), m_visibleState.end(),
+                  [](const SnapshotEntity& a, const SnapshotEntity& b) { return a.id < b.id; });
+        
+        m_visibleIds.clear();
+        for (const SnapshotEntity& entity : m_visibleState) {
+            m_visibleIds.push_back(entity.id);
+        }
+        
+        pair.second->updateKnownEntities(m_visibleIds, m_enteredIds, m_leftIds);
+        
+        for (uint32_t id : m_leftIds) {
+            pair.second->cancelSupersedingFrame(ClientSession::supersedeKey(PacketType::PLAYER_APPEARANCE, id));
+            pair.second->sendFrame(FramedBuffer::fromPacket(EntityDespawnPacket(id)));
+        }
+        
+        for (uint32_t id : m_enteredIds) {
+            auto frameIt = spawnFrames.find(id);
+            if (frameIt == spawnFrames.end()) {
+                std::shared_ptr<Entity> entity = m_world->getEntity(static_cast<int>(id));
+                if (!entity) {
+                    continue;
+                }
+                
+                Color color = entity->getColor();
+                EntitySpawnPacket spawn(id, entity->getX(), entity->getY(), entity->getSymbol(),
+                                        color.r, color.g, color.b, entity->getName());
+                frameIt = spawnFrames.emplace(id, FramedBuffer::fromPacket(spawn)).first;
+            }
+            pair.second->sendFrame(frameIt->second);
+        }
+        
+        pair.second->sendSnapshot(tick, m_visibleState);
+    }
+}
+
+FramedBuffer Server::getChunkFrame(const ChunkCoord& chunk, bool compressed) {
+    bool encoded = false;
+    FramedBuffer frame = m_chunkFrames->get(chunk, compressed, encoded);
+    if (encoded) {
+        m_metrics.chunkFramesEncoded.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_metrics.chunkFramesCached.fetch_add(1, std::memory_order_relaxed);
+    }
+    return frame;
+}
+
+bool Server::recordWorldModification(int x, int y, uint8_t tileType) {
+    return m_worldEdits.record(x, y, tileType);
+}
+
+bool Server::recordRegionEdit(const RegionMask& mask, uint8_t tileType) {
+    return m_worldEdits.recordRegion(mask, tileType);
+}
+
+void Server::flushWorldEdits() {
+    // Applied on the game thread, so concurrent edits land in one order
+    m_worldEdits.drain(m_tickRegions, m_tickEdits);
+    const int chunkSize = m_world->getChunkSize();
+    
+    for (const RegionEdit& region : m_tickRegions) {
+        const RegionMask& mask = region.mask;
+        m_world->fillRegion(mask.x, mask.y, mask.width, mask.height,
+                            mask.isFull() ? nullptr : mask.bits.data(),
+                            static_cast<TileType>(region.tileType));
+        
+        RegionUpdatePacket packet(mask.x, mask.y, mask.width, mask.height, region.tileType);
+        packet.getMask() = mask.bits;
+        FramedBuffer frame = FramedBuffer::fromPacket(packet);
+        
+        // Sent once to every client with any chunk of the region loaded
+        int minChunkX = mask.x / chunkSize;
+        int minChunkY = mask.y / chunkSize;
+        int maxChunkX = (mask.x + mask.width - 1) / chunkSize;
+        int maxChunkY = (mask.y + mask.height - 1) / chunkSize;
+        for (auto& pair : m_clients) {
+            bool loaded = false;
+            for (int chunkY = minChunkY; chunkY <= maxChunkY && !loaded; ++chunkY) {
+                for (int chunkX = minChunkX; chunkX <= maxChunkX && !loaded; ++chunkX) {
+                    loaded = pair.second->hasChunkLoaded(ChunkCoord{chunkX, chunkY});
+                }
+            }
+            if (loaded) {
+                pair.second->sendFrame(frame);
+            }
+        }
+    }
+    
+    for (const ChunkEdits& edits : m_tickEdits) {
+        // A later region may have covered every tile edited in this chunk
+        if (edits.changedCount == 0) {
+            continue;
+        }
+        m_world->setTiles(edits.originX, edits.originY, edits.width, edits.height,
+                          edits.bitmap.data(), edits.values.data());
+        
+        // Clients without the chunk get the edited tiles when it streams in
+        ChunkDeltaPacket packet(edits.originX, edits.originY, edits.width, edits.height);
+        edits.encode(packet.getDeltaData());
+        FramedBuffer frame = FramedBuffer::fromPacket(packet);
+        for (auto& pair : m_clients) {
+            if (pair.second->hasChunkLoaded(edits.chunk)) {
+                pair.second->sendFrame(frame);
+            }
+        }
+    }
+    
+    // Release the frames of chunks that changed rather than holding them
+    // until the next time the chunk is streamed
+    m_dirtyChunks.clear();
+    m_world->takeDirtyChunks(m_dirtyChunks);
+    for (const ChunkCoord& chunk : m_dirtyChunks) {
+        m_chunkFrames->invalidate(chunk);
     }
 }
 
@@ -231,8 +417,8 @@ void Server::startAccept() {
         return;
     }
     
-    // Create a new session
-    auto session = std::make_shared<ClientSession>(m_ioContext, this);
+    // Create a new session on the next io_context in the pool
+    auto session = std::make_shared<ClientSession>(m_ioPool.getIoContext(), this);
     
     // Accept a new connection
     m_acceptor.async_accept(
@@ -261,10 +447,10 @@ void Server::handleAccept(ClientSessionPtr session, const boost::system::error_c
             std::cerr << "Rejecting connection: maximum clients reached" << std::endl;
             session->close();
         } else {
-            // Start the session
-            session->start();
-            
-            std::lock_guard<std::mutex> lock(m_clientsMutex);
+            // Start the session on its own io_context thread
+            boost::asio::post(session->getSocket().get_executor(), [session]() {
+                session->start();
+            });
         }
     }
     
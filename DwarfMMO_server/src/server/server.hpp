@@ -7,6 +7,13 @@
 #include <thread>
 #include <mutex>
 #include "server/config.hpp"
+#include "server/io_context_pool.hpp"
+#include "server/metrics.hpp"
+#include "server/udp_channel.hpp"
+#include "server/world_edit_batch.hpp"
+#include "server/chunk_frame_cache.hpp"
+#include "network/framed_buffer.hpp"
+#include "network/snapshot.hpp"
 #include "game/world.hpp"
 
 using boost::asio::ip::tcp;
@@ -17,7 +24,7 @@ using ClientSessionPtr = std::shared_ptr<ClientSession>;
 
 class Server : public std::enable_shared_from_this<Server> {
 public:
-    Server(boost::asio::io_context& ioContext, const ServerConfig& config);
+    Server(IoContextPool& ioPool, const ServerConfig& config);
     ~Server();
     
     // Start the server
@@ -30,7 +37,7 @@ public:
     void tick();
     
     // Add a player to the world
-    void addPlayer(uint32_t playerId, std::shared_ptr<Player> player);
+    void addPlayer(std::shared_ptr<Player> player);
     
     // Remove a player from the world
     void removePlayer(uint32_t playerId);
@@ -41,15 +48,30 @@ public:
     // Get the world
     World* getWorld();
     
+    // Framed chunk packet (CompressedChunk or WorldChunk), re-encoded only if
+    // the chunk changed since it was last framed (game thread)
+    FramedBuffer getChunkFrame(const ChunkCoord& chunk, bool compressed);
+    
     // Get the server configuration
     const ServerConfig& getConfig() const;
     
-    // Broadcast player position to all clients
-    void broadcastPlayerPosition(uint32_t playerId, int x, int y);
+    // Send a player's appearance frame to the other clients that know the player
+    void broadcastPlayerAppearance(uint32_t playerId, int x, int y, const FramedBuffer& frame);
+    
+    // Queue a tile edit; it is applied and sent to the clients that have the
+    // chunk loaded at the end of the tick. False if the tile is outside the world
+    bool recordWorldModification(int x, int y, uint8_t tileType);
     
-    // Broadcast world modification to all clients
-    void broadcastWorldModification(int x, int y, uint8_t tileType);
+    // Queue a region edit, applied and sent the same way as one region
+    // update. False if the region isn't inside the world
+    bool recordRegionEdit(const RegionMask& mask, uint8_t tileType);
 
+    // Get the UDP side channel (null when disabled)
+    UdpChannel* getUdpChannel() { return m_udpChannel.get(); }
+    
+    // Get the server-wide counters
+    ServerMetrics& getMetrics() { return m_metrics; }
+    
     // Get the clients mutex (for synchronized access)
     std::mutex& getClientsMutex() { return m_clientsMutex; }
     
@@ -59,12 +81,13 @@ public:
     
 private:
     // Server state
-    boost::asio::io_context& m_ioContext;
+    IoContextPool& m_ioPool;
     ServerConfig m_config;
     std::atomic<bool> m_running;
     
     // Networking
     tcp::acceptor m_acceptor;
+    std::unique_ptr<UdpChannel> m_udpChannel;
     std::mutex m_clientsMutex;
     std::unordered_map<uint32_t, ClientSessionPtr> m_clients;
     
@@ -72,6 +95,25 @@ private:
     std::unique_ptr<World> m_world;
     std::atomic<uint32_t> m_nextPlayerId;
     
+    // Tile edits waiting for the end of the tick, and the game thread's drained copy
+    WorldEditBatch m_worldEdits;
+    std::vector<RegionEdit> m_tickRegions;
+    std::vector<ChunkEdits> m_tickEdits;
+    
+    // Encoded chunks shared by every session (game thread only)
+    std::unique_ptr<ChunkFrameCache> m_chunkFrames;
+    std::vector<ChunkCoord> m_dirtyChunks;
+    
+    // Counters and the tick count used to print them periodically
+    ServerMetrics m_metrics;
+    uint64_t m_tickCount;
+    
+    // Replication scratch (game thread only)
+    SnapshotState m_visibleState;
+    std::vector<uint32_t> m_visibleIds;
+    std::vector<uint32_t> m_enteredIds;
+    std::vector<uint32_t> m_leftIds;
+    
     // Game loop thread
     std::thread m_gameThread;
     
@@ -83,6 +125,22 @@ private:
     
     // Game loop function
     void gameLoop();
+    
+    // Players inside the view area of a client standing at (x, y). A client
+    // sees the chunks within viewRadiusChunks of its own chunk, so this is
+    // also the set of clients whose view contains (x, y)
+    EntitySpan getPlayersInView(int x, int y) const;
+    
+    // Diff every client's visible players against what it knows, send
+    // spawns for the ones that entered and despawns for the ones that left,
+    // then a snapshot of their positions (call with the clients mutex held)
+    void replicateToClients(uint32_t tick);
+    
+    // Apply the region and tile edits recorded since the last tick. Each
+    // region goes as one update and each edited chunk as one delta to the
+    // clients that have the affected chunks loaded (call with the clients
+    // mutex held)
+    void flushWorldEdits();
 };
 
 using ServerPtr = std::shared_ptr<Server>;
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "server/udp_channel.hpp"
+#include "server/client_session.hpp"
+#include <iostream>
+
+UdpChannel::UdpChannel(boost::asio::io_context& ioContext, uint16_t port)
+    : m_ioContext(ioContext),
+      m_socket(ioContext, udp::endpoint(udp::v4(), port)),
+      m_port(port) {
+}
+
+UdpChannel::~UdpChannel() {
+    stop();
+}
+
+void UdpChannel::start() {
+    startReceive();
+    std::cout << "UDP side channel listening on port " << m_port << std::endl;
+}
+
+void UdpChannel::stop() {
+    boost::system::error_code ec;
+    m_socket.close(ec);
+}
+
+uint32_t UdpChannel::registerSession(const std::shared_ptr<ClientSession>& session) {
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+
+    // Every token is drawn straight from the OS random source: a seeded PRNG
+    // would let a client that collects its own tokens predict the next ones
+    // and bind its endpoint to someone else's session. Zero is reserved for
+    // "not registered"
+    uint32_t token;
+    do {
+        token = m_tokenSource();
+    } while (token == 0 || m_registrations.count(token) > 0);
+
+    m_registrations[token].session = session;
+    return token;
+}
+
+void UdpChannel::unregisterSession(uint32_t token) {
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    auto it = m_registrations.find(token);
+    if (it == m_registrations.end()) {
+        return;
+    }
+
+    if (it->second.bound) {
+        m_tokensByEndpoint.erase(it->second.endpoint);
+    }
+    m_registrations.erase(it);
+}
+
+void UdpChannel::sendTo(const udp::endpoint& endpoint, std::vector<uint8_t> datagram) {
+    // The socket is only used from its own io_context thread
+    auto bytes = std::make_shared<std::vector<uint8_t>>(std::move(datagram));
+    boost::asio::post(m_ioContext, [this, endpoint, bytes]() {
+        m_socket.async_send_to(
+            boost::asio::buffer(*bytes),
+            endpoint,
+            [bytes](const boost::system::error_code&, size_t) {
+                // Unreliable by design: a failed send is just a lost datagram
+            }
+        );
+    });
+}
+
+void UdpChannel::startReceive() {
+    if (!m_socket.is_open()) {
+        return;
+    }
+
+    m_socket.async_receive_from(
+        boost::asio::buffer(m_receiveBuffer),
+        m_senderEndpoint,
+        [this](const boost::system::error_code& error, size_t bytesTransferred) {
+            handleReceive(error, bytesTransferred);
+        }
+    );
+}
+
+void UdpChannel::handleReceive(const boost::system::error_code& error, size_t bytesTransferred) {
+    if (error == boost::asio::error::operation_aborted) {
+        return;
+    }
+
+    // Anything without a sequence and a type byte is noise
+    if (!error && bytesTransferred > DATAGRAM_HEADER_SIZE) {
+        uint32_t sequence = codec::load<uint32_t>(m_receiveBuffer.data());
+        const uint8_t* packet = m_receiveBuffer.data() + DATAGRAM_HEADER_SIZE;
+        size_t packetSize = bytesTransferred - DATAGRAM_HEADER_SIZE;
+
+        if (static_cast<PacketType>(packet[0]) == PacketType::UDP_HELLO) {
+            handleHello(m_senderEndpoint, packet, packetSize);
+        } else {
+            std::shared_ptr<ClientSession> session;
+            {
+                std::lock_guard<std::mutex> lock(m_sessionsMutex);
+                auto it = m_tokensByEndpoint.find(m_senderEndpoint);
+                if (it != m_tokensByEndpoint.end()) {
+                    session = m_registrations[it->second].session.lock();
+                }
+            }
+
+            // Datagrams from unknown endpoints are dropped
+            if (session) {
+                session->receiveDatagram(sequence, packet, packetSize);
+            }
+        }
+    }
+
+    startReceive();
+}
+
+void UdpChannel::handleHello(const udp::endpoint& sender, const uint8_t* packet, size_t size) {
+    UdpHelloView hello;
+    if (!hello.bind(packet, size)) {
+        return;
+    }
+
+    std::shared_ptr<ClientSession> session;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionsMutex);
+        auto it = m_registrations.find(hello.getToken());
+        if (it == m_registrations.end()) {
+            return;
+        }
+
+        Registration& registration = it->second;
+        session = registration.session.lock();
+        if (!session) {
+            return;
+        }
+
+        // The first endpoint to present the token owns it; repeated hellos
+        // (retries) from the same endpoint are acknowledged again
+        if (registration.bound && registration.endpoint != sender) {
+            return;
+        }
+        if (!registration.bound) {
+            registration.bound = true;
+            registration.endpoint = sender;
+            m_tokensByEndpoint[sender] = it->first;
+        }
+    }
+
+    session->bindUdpEndpoint(sender);
+
+    // Echo the hello so the client knows the channel works both ways
+    sendTo(sender, makeDatagram(0, packet, size));
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <memory>
+#include <array>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <random>
+#include <boost/asio.hpp>
+#include "network/datagram.hpp"
+
+using boost::asio::ip::udp;
+
+// Forward declarations
+class ClientSession;
+
+// Unreliable side channel for high-frequency state (player positions).
+// A session registers for a random token, offers it to its client over TCP,
+// and the client proves ownership of a UDP endpoint by sending the token back
+// in a UdpHello datagram. Everything else stays on the session's TCP stream.
+class UdpChannel {
+public:
+    UdpChannel(boost::asio::io_context& ioContext, uint16_t port);
+    ~UdpChannel();
+
+    // Start receiving datagrams
+    void start();
+
+    // Close the socket
+    void stop();
+
+    // Register a session; returns the token its client must present
+    uint32_t registerSession(const std::shared_ptr<ClientSession>& session);
+
+    // Forget a session's token and endpoint
+    void unregisterSession(uint32_t token);
+
+    // Send a datagram (safe from any thread)
+    void sendTo(const udp::endpoint& endpoint, std::vector<uint8_t> datagram);
+
+    uint16_t getPort() const { return m_port; }
+
+    // Disable copying
+    UdpChannel(const UdpChannel&) = delete;
+    UdpChannel& operator=(const UdpChannel&) = delete;
+
+private:
+    boost::asio::io_context& m_ioContext;
+    udp::socket m_socket;
+    uint16_t m_port;
+
+    // Receive state (only touched by the receive handler)
+    std::array<uint8_t, MAX_DATAGRAM_SIZE> m_receiveBuffer;
+    udp::endpoint m_senderEndpoint;
+
+    struct Registration {
+        std::weak_ptr<ClientSession> session;
+        udp::endpoint endpoint;
+        bool bound = false;
+    };
+
+    // Sessions by token (handshake) and tokens by endpoint (traffic)
+    std::mutex m_sessionsMutex;
+    std::unordered_map<uint32_t, Registration> m_registrations;
+    std::map<udp::endpoint, uint32_t> m_tokensByEndpoint;
+    // OS random source for tokens, used under m_sessionsMutex
+    std::random_device m_tokenSource;
+
+    // Start receiving the next datagram
+    void startReceive();
+
+    // Handle a received datagram
+    void handleReceive(const boost::system::error_code& error, size_t bytesTransferred);
+
+    // Bind the sender to the session owning the token and acknowledge
+    void handleHello(const udp::endpoint& sender, const uint8_t* packet, size_t size);
+};
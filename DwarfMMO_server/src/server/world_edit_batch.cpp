@@ -0,0 +1,100 @@
+#include "server/world_edit_batch.hpp"
+#include <algorithm>
+
+void ChunkEdits::encode(std::vector<uint8_t>& out) const {
+    out.reserve(out.size() + bitmap.size() + changedCount);
+    out.insert(out.end(), bitmap.begin(), bitmap.end());
+    size_t tileCount = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < tileCount; ++i) {
+        if (isChanged(i)) {
+            out.push_back(values[i]);
+        }
+    }
+}
+
+WorldEditBatch::WorldEditBatch(int chunkSize, int worldWidth, int worldHeight)
+    : m_chunkSize(std::max(1, chunkSize)),
+      m_worldWidth(worldWidth),
+      m_worldHeight(worldHeight) {
+}
+
+bool WorldEditBatch::record(int x, int y, uint8_t tileType) {
+    if (x < 0 || y < 0 || x >= m_worldWidth || y >= m_worldHeight) {
+        return false;
+    }
+
+    int chunkX = x / m_chunkSize;
+    int chunkY = y / m_chunkSize;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key(chunkX, chunkY));
+    if (it == m_index.end()) {
+        ChunkEdits edits;
+        edits.chunk = ChunkCoord{chunkX, chunkY};
+        edits.originX = chunkX * m_chunkSize;
+        edits.originY = chunkY * m_chunkSize;
+        edits.width = std::min(m_chunkSize, m_worldWidth - edits.originX);
+        edits.height = std::min(m_chunkSize, m_worldHeight - edits.originY);
+        size_t tileCount = static_cast<size_t>(edits.width) * edits.height;
+        edits.bitmap.assign((tileCount + 7) / 8, 0);
+        edits.values.assign(tileCount, 0);
+        edits.changedCount = 0;
+        it = m_index.emplace(key(chunkX, chunkY), m_chunks.size()).first;
+        m_chunks.push_back(std::move(edits));
+    }
+
+    // Last write wins
+    ChunkEdits& edits = m_chunks[it->second];
+    size_t index = static_cast<size_t>(y - edits.originY) * edits.width + (x - edits.originX);
+    if (!edits.isChanged(index)) {
+        edits.bitmap[index >> 3] |= static_cast<uint8_t>(1u << (index & 7));
+        ++edits.changedCount;
+    }
+    edits.values[index] = tileType;
+    return true;
+}
+
+bool WorldEditBatch::recordRegion(const RegionMask& mask, uint8_t tileType) {
+    if (mask.x < 0 || mask.y < 0 || mask.width <= 0 || mask.height <= 0 ||
+        mask.x > m_worldWidth - mask.width || mask.y > m_worldHeight - mask.height) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Earlier single-tile edits under the region are overwritten by it
+    for (int chunkY = mask.y / m_chunkSize; chunkY <= (mask.y + mask.height - 1) / m_chunkSize; ++chunkY) {
+        for (int chunkX = mask.x / m_chunkSize; chunkX <= (mask.x + mask.width - 1) / m_chunkSize; ++chunkX) {
+            auto it = m_index.find(key(chunkX, chunkY));
+            if (it == m_index.end()) {
+                continue;
+            }
+            ChunkEdits& edits = m_chunks[it->second];
+            int minX = std::max(mask.x, edits.originX);
+            int minY = std::max(mask.y, edits.originY);
+            int maxX = std::min(mask.x + mask.width, edits.originX + edits.width);
+            int maxY = std::min(mask.y + mask.height, edits.originY + edits.height);
+            for (int y = minY; y < maxY; ++y) {
+                for (int x = minX; x < maxX; ++x) {
+                    size_t regionIndex = static_cast<size_t>(y - mask.y) * mask.width + (x - mask.x);
+                    size_t index = static_cast<size_t>(y - edits.originY) * edits.width + (x - edits.originX);
+                    if (mask.covers(regionIndex) && edits.isChanged(index)) {
+                        edits.bitmap[index >> 3] &= static_cast<uint8_t>(~(1u << (index & 7)));
+                        --edits.changedCount;
+                    }
+                }
+            }
+        }
+    }
+
+    m_regions.push_back(RegionEdit{mask, tileType});
+    return true;
+}
+
+void WorldEditBatch::drain(std::vector<RegionEdit>& regions, std::vector<ChunkEdits>& chunks) {
+    regions.clear();
+    chunks.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    regions.swap(m_regions);
+    chunks.swap(m_chunks);
+    m_index.clear();
+}
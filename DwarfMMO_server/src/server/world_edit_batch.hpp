@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include "server/chunk_streamer.hpp"
+#include "network/region_edit.hpp"
+
+// Tile edits made to one chunk during a tick
+struct ChunkEdits {
+    ChunkCoord chunk;
+    // Tile rectangle covered by the chunk (clipped to the world)
+    int originX;
+    int originY;
+    int width;
+    int height;
+    // One bit per tile, row-major, least significant bit first
+    std::vector<uint8_t> bitmap;
+    // Latest tile type per tile; only meaningful where the bit is set
+    std::vector<uint8_t> values;
+    size_t changedCount;
+
+    bool isChanged(size_t index) const { return (bitmap[index >> 3] >> (index & 7)) & 1u; }
+
+    // Append the ChunkDelta wire form: the bitmap, then the changed values in order
+    void encode(std::vector<uint8_t>& out) const;
+};
+
+// A region set to one tile type
+struct RegionEdit {
+    RegionMask mask;
+    uint8_t tileType;
+};
+
+// Tile edits collected between ticks, grouped by chunk. Sessions record edits
+// from their IO threads; the game thread drains the batch once per tick,
+// applies it and sends each chunk's changes as one delta. Editing the same
+// tile again within a tick only replaces the value that will be sent.
+// Region edits are kept whole and applied before the single-tile edits; a
+// region drops the single-tile edits it covers that were recorded before it,
+// so the result matches applying everything in the order it arrived.
+class WorldEditBatch {
+public:
+    WorldEditBatch(int chunkSize, int worldWidth, int worldHeight);
+
+    // Record an edit; false if the tile is outside the world
+    bool record(int x, int y, uint8_t tileType);
+
+    // Record a region edit; false unless the region lies inside the world
+    bool recordRegion(const RegionMask& mask, uint8_t tileType);
+
+    // Move the regions and chunks edited since the last drain into the
+    // vectors (cleared first); apply the regions first, in order
+    void drain(std::vector<RegionEdit>& regions, std::vector<ChunkEdits>& chunks);
+
+private:
+    int m_chunkSize;
+    int m_worldWidth;
+    int m_worldHeight;
+
+    std::mutex m_mutex;
+    std::vector<RegionEdit> m_regions;
+    std::vector<ChunkEdits> m_chunks;
+    // Chunk key -> index into m_chunks
+    std::unordered_map<uint64_t, size_t> m_index;
+
+    static uint64_t key(int chunkX, int chunkY) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY);
+    }
+};
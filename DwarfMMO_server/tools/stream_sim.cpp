@@ -0,0 +1,246 @@
+// Offline walk test for chunk streaming and prefetching.
+//
+// A simulated player wanders a large world at a fixed speed while the
+// server side runs the same per-tick steps as ClientSession::streamChunks
+// (ChunkStreamer plus MotionTracker) against a modelled link: chunks queue
+// behind a bandwidth limit and arrive after a one-way latency, and position
+// reports reach the server after the same latency. Every time the player
+// walks into a new chunk the test checks whether the whole view around it
+// had already arrived. It runs once without and once with prefetching, and
+// fails (exit status 1) if more than the allowed share of crossings with
+// prefetching found the view incomplete.
+//
+// Usage: StreamSim [speed tiles/s] [latency ms] [link KiB/s] [crossings] [seed] [allowed %]
+
+#include "server/chunk_streamer.hpp"
+#include "server/motion_tracker.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct SimConfig {
+    float speed = 20.0f;          // Tiles per second
+    int latencyMs = 100;          // One way
+    size_t linkBytesPerSecond = 256 * 1024;
+    int crossings = 150;          // Chunk borders to cross before stopping
+    uint32_t seed = 1;
+    float allowedPercent = 2.0f;  // Incomplete views tolerated with prefetching
+
+    // Server defaults (ServerConfig)
+    int tickRate = 20;
+    int chunkSize = 16;
+    int viewRadius = 3;
+    size_t budgetBytes = 16 * 1024;
+    size_t chunkBytes = 281;      // Framed raw WorldChunk of 16x16 tiles
+    int worldSize = 4096;
+};
+
+// Same look-ahead as ClientSession::streamChunks
+constexpr float PREFETCH_LEAD_SECONDS = 0.5f;
+constexpr float MAX_SPEED_FACTOR = 4.0f;
+
+struct SimResult {
+    int crossings = 0;
+    int incomplete = 0;
+};
+
+uint64_t key(int x, int y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+int floorDivide(float value, int divisor) {
+    return static_cast<int>(std::floor(value / divisor));
+}
+
+SimResult simulate(const SimConfig& config, bool prefetch) {
+    using Clock = MotionTracker::Clock;
+    const float dt = 1.0f / config.tickRate;
+    const int latencyTicks = std::max(0, config.latencyMs * config.tickRate / 1000);
+    const size_t linkBytesPerTick = config.linkBytesPerSecond / config.tickRate;
+    const int columns = config.worldSize / config.chunkSize;
+    // What the session measures from snapshot acks on this link
+    const float roundTripSeconds = 2.0f * latencyTicks / config.tickRate;
+    // The walker moves at the server's nominal player speed
+    const float maxSpeed = MAX_SPEED_FACTOR * config.speed;
+
+    ChunkStreamer streamer(config.viewRadius, columns, columns);
+    MotionTracker motion;
+    std::vector<ChunkCoord> unloaded;
+
+    // Position reports in flight to the server: (arrival tick, x, y)
+    struct Report { int tick; int x; int y; };
+    std::deque<Report> reports;
+
+    // Chunks queued on the link, and when each chunk reached the client
+    struct Queued { ChunkCoord chunk; size_t bytesLeft; };
+    std::deque<Queued> link;
+    size_t linkBacklog = 0;
+    std::unordered_map<uint64_t, int> arrivedAt;
+
+    // Walk in one of eight directions, turning every few seconds
+    std::mt19937 random(config.seed);
+    float x = config.worldSize / 2.0f;
+    float y = config.worldSize / 2.0f;
+    float dirX = 1.0f;
+    float dirY = 0.0f;
+    int serverX = static_cast<int>(x);
+    int serverY = static_cast<int>(y);
+    int chunkX = floorDivide(x, config.chunkSize);
+    int chunkY = floorDivide(y, config.chunkSize);
+
+    SimResult result;
+    Clock::time_point start = Clock::now();
+    const int warmupTicks = 2 * config.tickRate;
+    for (int tick = 0; result.crossings < config.crossings; ++tick) {
+        Clock::time_point now = start + std::chrono::milliseconds(tick * 1000 / config.tickRate);
+
+        // Client: move, turning now and then, and keep away from the edge
+        if (tick >= warmupTicks && (tick - warmupTicks) % (3 * config.tickRate) == 0) {
+            float angle = static_cast<float>(random() % 8) * 3.14159265f / 4.0f;
+            dirX = std::cos(angle);
+            dirY = std::sin(angle);
+        }
+        if (tick >= warmupTicks) {
+            float margin = static_cast<float>((config.viewRadius + 4) * config.chunkSize);
+            if (x < margin || x > config.worldSize - margin) {
+                dirX = x < margin ? std::fabs(dirX) : -std::fabs(dirX);
+            }
+            if (y < margin || y > config.worldSize - margin) {
+                dirY = y < margin ? std::fabs(dirY) : -std::fabs(dirY);
+            }
+            x += dirX * config.speed * dt;
+            y += dirY * config.speed * dt;
+            reports.push_back(Report{tick + latencyTicks, static_cast<int>(x), static_cast<int>(y)});
+        }
+
+        // Client: entering a chunk, is the whole view there already?
+        int newChunkX = floorDivide(x, config.chunkSize);
+        int newChunkY = floorDivide(y, config.chunkSize);
+        if (newChunkX != chunkX || newChunkY != chunkY) {
+            chunkX = newChunkX;
+            chunkY = newChunkY;
+            bool complete = true;
+            for (int cy = chunkY - config.viewRadius; cy <= chunkY + config.viewRadius; ++cy) {
+                for (int cx = chunkX - config.viewRadius; cx <= chunkX + config.viewRadius; ++cx) {
+                    auto it = arrivedAt.find(key(cx, cy));
+                    if (it == arrivedAt.end() || it->second > tick) {
+                        complete = false;
+                    }
+                }
+            }
+            ++result.crossings;
+            if (!complete) {
+                ++result.incomplete;
+            }
+        }
+
+        // Server: position reports that have arrived
+        while (!reports.empty() && reports.front().tick <= tick) {
+            serverX = reports.front().x;
+            serverY = reports.front().y;
+            motion.addSample(serverX, serverY, now);
+            reports.pop_front();
+        }
+
+        // Server: the steps of ClientSession::streamChunks
+        unloaded.clear();
+        streamer.setCenter(floorDivide(static_cast<float>(serverX), config.chunkSize),
+                           floorDivide(static_cast<float>(serverY), config.chunkSize), unloaded);
+        for (const ChunkCoord& chunk : unloaded) {
+            arrivedAt.erase(key(chunk.x, chunk.y));
+        }
+
+        int aheadX = serverX;
+        int aheadY = serverY;
+        float vx = 0.0f;
+        float vy = 0.0f;
+        if (prefetch && motion.estimateVelocity(vx, vy, maxSpeed, now)) {
+            float horizon = PREFETCH_LEAD_SECONDS + roundTripSeconds;
+            float maxCoord = static_cast<float>(config.worldSize - 1);
+            aheadX = static_cast<int>(std::clamp(aheadX + vx * horizon, 0.0f, maxCoord));
+            aheadY = static_cast<int>(std::clamp(aheadY + vy * horizon, 0.0f, maxCoord));
+        }
+        streamer.setPrefetchCenter(floorDivide(static_cast<float>(aheadX), config.chunkSize),
+                                   floorDivide(static_cast<float>(aheadY), config.chunkSize));
+
+        size_t sent = 0;
+        ChunkCoord chunk;
+        while (sent < config.budgetBytes && streamer.popNext(chunk)) {
+            link.push_back(Queued{chunk, config.chunkBytes});
+            sent += config.chunkBytes;
+        }
+        linkBacklog += sent;
+        if (prefetch && linkBacklog <= config.budgetBytes) {
+            size_t prefetched = 0;
+            while (sent < config.budgetBytes && streamer.popNextPrefetch(chunk)) {
+                link.push_back(Queued{chunk, config.chunkBytes});
+                sent += config.chunkBytes;
+                prefetched += config.chunkBytes;
+            }
+            linkBacklog += prefetched;
+        }
+
+        // Link: drain this tick's bandwidth; finished chunks land after the latency
+        size_t capacity = linkBytesPerTick;
+        while (capacity > 0 && !link.empty()) {
+            Queued& front = link.front();
+            size_t bytes = std::min(capacity, front.bytesLeft);
+            front.bytesLeft -= bytes;
+            capacity -= bytes;
+            linkBacklog -= bytes;
+            if (front.bytesLeft == 0) {
+                if (streamer.isLoaded(front.chunk)) {
+                    arrivedAt[key(front.chunk.x, front.chunk.y)] = tick + latencyTicks;
+                }
+                link.pop_front();
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    SimConfig config;
+    try {
+        if (argc > 1) config.speed = std::stof(argv[1]);
+        if (argc > 2) config.latencyMs = std::stoi(argv[2]);
+        if (argc > 3) config.linkBytesPerSecond = static_cast<size_t>(std::stoul(argv[3])) * 1024;
+        if (argc > 4) config.crossings = std::stoi(argv[4]);
+        if (argc > 5) config.seed = static_cast<uint32_t>(std::stoul(argv[5]));
+        if (argc > 6) config.allowedPercent = std::stof(argv[6]);
+    } catch (const std::exception&) {
+        std::cerr << "Usage: StreamSim [speed tiles/s] [latency ms] [link KiB/s] [crossings] [seed] [allowed %]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Walking at " << config.speed << " tiles/s, " << config.latencyMs << " ms latency, "
+              << config.linkBytesPerSecond / 1024 << " KiB/s link" << std::endl;
+    SimResult withPrefetch;
+    for (bool prefetch : {false, true}) {
+        SimResult result = simulate(config, prefetch);
+        std::cout << (prefetch ? "  with prefetch:    " : "  without prefetch: ")
+                  << "view incomplete on arrival " << result.incomplete << "/" << result.crossings
+                  << " chunk crossings" << std::endl;
+        if (prefetch) {
+            withPrefetch = result;
+        }
+    }
+
+    if (withPrefetch.incomplete * 100.0f > config.allowedPercent * withPrefetch.crossings) {
+        std::cerr << "FAIL: more than " << config.allowedPercent
+                  << "% of crossings with prefetch found the view incomplete" << std::endl;
+        return 1;
+    }
+    return 0;
+}
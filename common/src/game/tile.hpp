@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Tile types are sent as single bytes, so client and server share them.
+// A tile is just its type; everything else about it comes from a
+// compile-time table, which keeps a whole world map at one byte per tile.
+
+// Tile type enum
+enum class TileType : uint8_t {
+    EMPTY,
+    FLOOR,
+    WALL,
+    GREEN_WALL
+};
+
+// Number of tile types; ids at or above this are invalid
+constexpr size_t TILE_TYPE_COUNT = 4;
+
+// What a tile type looks like and whether it blocks movement
+struct TileProperties {
+    char symbol;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    bool solid;
+};
+
+// Indexed by TileType
+constexpr std::array<TileProperties, TILE_TYPE_COUNT> TILE_PROPERTIES = {{
+    {' ', 0, 0, 0, false},         // EMPTY
+    {'.', 100, 100, 100, false},   // FLOOR
+    {'#', 150, 150, 150, true},    // WALL
+    {'#', 0, 200, 0, true},        // GREEN_WALL
+}};
+
+// True for ids that name a tile type (check anything read off the network)
+constexpr bool isValidTileType(uint8_t id) {
+    return id < TILE_TYPE_COUNT;
+}
+
+// Properties of a tile type; unknown ids look and behave like a wall
+constexpr const TileProperties& tileProperties(TileType type) {
+    return isValidTileType(static_cast<uint8_t>(type)) ? TILE_PROPERTIES[static_cast<size_t>(type)]
+                                                        : TILE_PROPERTIES[static_cast<size_t>(TileType::WALL)];
+}
+
+// Tile structure: one byte, the rest is looked up
+struct Tile {
+    TileType type;
+    
+    constexpr Tile(TileType t = TileType::EMPTY) : type(t) {}
+    
+    constexpr char symbol() const { return tileProperties(type).symbol; }
+    constexpr bool solid() const { return tileProperties(type).solid; }
+};
+
+static_assert(sizeof(Tile) == 1, "Tiles are stored one byte each");
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Bit-level writer for packed payloads. Bits are appended most significant
+// first and whole bytes go straight into the target vector; flush() pads the
+// last partial byte with zeros.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& buffer)
+        : m_buffer(buffer), m_bits(0), m_count(0) {
+    }
+
+    // Append the low count bits of value (count <= 32)
+    void write(uint32_t value, unsigned count) {
+        if (count == 0) {
+            return;
+        }
+        uint64_t mask = (uint64_t(1) << count) - 1;
+        m_bits = (m_bits << count) | (value & mask);
+        m_count += count;
+        while (m_count >= 8) {
+            m_count -= 8;
+            m_buffer.push_back(static_cast<uint8_t>(m_bits >> m_count));
+        }
+        m_bits &= (uint64_t(1) << m_count) - 1;
+    }
+
+    void writeBit(bool bit) { write(bit ? 1 : 0, 1); }
+
+    // Write out the last partial byte
+    void flush() {
+        if (m_count > 0) {
+            m_buffer.push_back(static_cast<uint8_t>(m_bits << (8 - m_count)));
+            m_bits = 0;
+            m_count = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_buffer;
+    uint64_t m_bits;
+    unsigned m_count;
+};
+
+// Bit-level reader over an untrusted buffer. Like ByteReader it never throws:
+// reading past the end fails and leaves the reader failed.
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : m_data(data), m_sizeBits(size * 8), m_position(0), m_failed(false) {
+    }
+
+    // Read count bits (count <= 32) into value
+    bool read(unsigned count, uint32_t& value) {
+        if (m_failed || count > 32 || count > m_sizeBits - m_position) {
+            m_failed = true;
+            return false;
+        }
+
+        uint32_t result = 0;
+        while (count > 0) {
+            unsigned available = 8 - static_cast<unsigned>(m_position & 7);
+            unsigned take = count < available ? count : available;
+            uint32_t byte = m_data[m_position >> 3];
+            result = (result << take) | ((byte >> (available - take)) & ((1u << take) - 1));
+            m_position += take;
+            count -= take;
+        }
+        value = result;
+        return true;
+    }
+
+    bool readBit(bool& bit) {
+        uint32_t value = 0;
+        if (!read(1, value)) {
+            return false;
+        }
+        bit = value != 0;
+        return true;
+    }
+
+    bool ok() const { return !m_failed; }
+    size_t remainingBits() const { return m_sizeBits - m_position; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_sizeBits;
+    size_t m_position;
+    bool m_failed;
+};
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Byte order helpers shared by the codec, views and streams
+namespace codec {
+
+template<typename T>
+inline T byteSwap(T value) {
+    static_assert(std::is_unsigned<T>::value, "byteSwap needs an unsigned type");
+    if constexpr (sizeof(T) == 1) {
+        return value;
+    } else if constexpr (sizeof(T) == 2) {
+        return static_cast<T>((value >> 8) | (value << 8));
+    } else if constexpr (sizeof(T) == 4) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _byteswap_ulong(value);
+#else
+        return __builtin_bswap32(value);
+#endif
+    } else {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _byteswap_uint64(value);
+#else
+        return __builtin_bswap64(value);
+#endif
+    }
+}
+
+template<typename T>
+inline T toBigEndian(T value) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return value;
+#else
+    return byteSwap(value);
+#endif
+}
+
+// Store an integer in a single write; returns the position after it
+template<typename T>
+inline uint8_t* store(uint8_t* out, T value) {
+    using Unsigned = std::make_unsigned_t<T>;
+    Unsigned wire = toBigEndian(static_cast<Unsigned>(value));
+    std::memcpy(out, &wire, sizeof(T));
+    return out + sizeof(T);
+}
+
+// Load an integer in a single read
+template<typename T>
+inline T load(const uint8_t* in) {
+    using Unsigned = std::make_unsigned_t<T>;
+    Unsigned wire;
+    std::memcpy(&wire, in, sizeof(T));
+    return static_cast<T>(toBigEndian(wire));
+}
+
+} // namespace codec
+
+// Forward-only reader over an untrusted buffer.
+// Never throws: a read past the end fails, returns false and leaves the reader
+// in a failed state, so a whole packet can be decoded and checked once with
+// ok(). Callers that already proved the bytes are there with require() can use
+// the unchecked reads.
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size)
+        : m_data(data), m_size(size), m_offset(0), m_failed(false) {
+    }
+
+    // Check that count more bytes are available; fails the reader if not
+    bool require(size_t count) {
+        if (m_failed || count > m_size - m_offset) {
+            m_failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    // Read an integer after require() covered it
+    template<typename T>
+    T readUnchecked() {
+        T value = codec::load<T>(m_data + m_offset);
+        m_offset += sizeof(T);
+        return value;
+    }
+
+    // Bounds-checked integer read
+    template<typename T>
+    bool read(T& value) {
+        if (!require(sizeof(T))) {
+            return false;
+        }
+        value = readUnchecked<T>();
+        return true;
+    }
+
+    // Borrow count bytes from the buffer without copying
+    bool readBytes(size_t count, const uint8_t*& bytes) {
+        if (!require(count)) {
+            return false;
+        }
+        bytes = m_data + m_offset;
+        m_offset += count;
+        return true;
+    }
+
+    // Read a 16-bit length-prefixed string without copying
+    bool readString(std::string_view& value) {
+        uint16_t length = 0;
+        const uint8_t* bytes = nullptr;
+        if (!read(length) || !readBytes(length, bytes)) {
+            return false;
+        }
+        value = std::string_view(reinterpret_cast<const char*>(bytes), length);
+        return true;
+    }
+
+    // Advance past count bytes
+    bool skip(size_t count) {
+        if (!require(count)) {
+            return false;
+        }
+        m_offset += count;
+        return true;
+    }
+
+    bool ok() const { return !m_failed; }
+    size_t position() const { return m_offset; }
+    size_t remaining() const { return m_size - m_offset; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset;
+    bool m_failed;
+};
+
+// Forward-only writer into space reserved up front.
+// The constructor grows the target vector once by the exact encoded size;
+// every write is then a plain store into that space. Writing more than was
+// reserved fails the writer instead of reallocating.
+class ByteWriter {
+public:
+    ByteWriter(std::vector<uint8_t>& buffer, size_t size)
+        : m_failed(false) {
+        size_t start = buffer.size();
+        buffer.resize(start + size);
+        m_out = buffer.data() + start;
+        m_end = m_out + size;
+    }
+
+    // Check that count more bytes fit in the reserved space
+    bool require(size_t count) {
+        if (m_failed || count > static_cast<size_t>(m_end - m_out)) {
+            m_failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    template<typename T>
+    bool write(T value) {
+        if (!require(sizeof(T))) {
+            return false;
+        }
+        m_out = codec::store(m_out, value);
+        return true;
+    }
+
+    bool writeBytes(const uint8_t* bytes, size_t count) {
+        if (!require(count)) {
+            return false;
+        }
+        if (count > 0) {
+            std::memcpy(m_out, bytes, count);
+        }
+        m_out += count;
+        return true;
+    }
+
+    // Write a 16-bit length-prefixed string
+    bool writeString(std::string_view value) {
+        return write(static_cast<uint16_t>(value.size())) &&
+               writeBytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+    }
+
+    bool ok() const { return !m_failed; }
+
+    // True when the reserved space was filled exactly
+    bool complete() const { return !m_failed && m_out == m_end; }
+
+private:
+    uint8_t* m_out;
+    uint8_t* m_end;
+    bool m_failed;
+};
@@ -0,0 +1,161 @@
+#include "network/chunk_codec.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+constexpr size_t MAX_LITERAL = 128;
+constexpr size_t MIN_RUN = 3;
+constexpr size_t MAX_RUN = 130;
+
+// Index width for a palette: 0 for a single entry, else 1, 2, 4 or 8 bits
+unsigned bitsForPalette(size_t paletteSize) {
+    if (paletteSize <= 1) {
+        return 0;
+    }
+    if (paletteSize <= 2) {
+        return 1;
+    }
+    if (paletteSize <= 4) {
+        return 2;
+    }
+    return paletteSize <= 16 ? 4 : 8;
+}
+
+size_t packedSize(size_t tileCount, unsigned bits) {
+    return (tileCount * bits + 7) / 8;
+}
+
+// Length of the run of bytes equal to data[0], at most limit
+size_t runLength(const uint8_t* data, size_t limit) {
+    size_t length = 1;
+    while (length < limit && data[length] == data[0]) {
+        ++length;
+    }
+    return length;
+}
+
+} // namespace
+
+void encodeChunkTiles(const uint8_t* tiles, size_t tileCount, std::vector<uint8_t>& out) {
+    // Palette in order of first appearance
+    std::array<int, 256> indexOf;
+    indexOf.fill(-1);
+    std::array<uint8_t, 256> palette;
+    size_t paletteSize = 0;
+    for (size_t i = 0; i < tileCount; ++i) {
+        if (indexOf[tiles[i]] < 0) {
+            indexOf[tiles[i]] = static_cast<int>(paletteSize);
+            palette[paletteSize++] = tiles[i];
+        }
+    }
+    if (paletteSize == 0) {
+        palette[paletteSize++] = 0;
+    }
+
+    out.push_back(static_cast<uint8_t>(paletteSize - 1));
+    out.insert(out.end(), palette.begin(), palette.begin() + paletteSize);
+
+    unsigned bits = bitsForPalette(paletteSize);
+    if (bits == 0) {
+        return;
+    }
+
+    // Pack the indices
+    thread_local std::vector<uint8_t> packed;
+    packed.assign(packedSize(tileCount, bits), 0);
+    unsigned perByte = 8 / bits;
+    for (size_t i = 0; i < tileCount; ++i) {
+        packed[i / perByte] |= static_cast<uint8_t>(indexOf[tiles[i]] << ((i % perByte) * bits));
+    }
+
+    // Run-length code the packed bytes
+    size_t literalStart = 0;
+    size_t i = 0;
+    auto flushLiterals = [&](size_t end) {
+        while (literalStart < end) {
+            size_t count = std::min(MAX_LITERAL, end - literalStart);
+            out.push_back(static_cast<uint8_t>(count - 1));
+            out.insert(out.end(), packed.begin() + literalStart, packed.begin() + literalStart + count);
+            literalStart += count;
+        }
+    };
+    while (i < packed.size()) {
+        size_t run = runLength(&packed[i], std::min(MAX_RUN, packed.size() - i));
+        if (run >= MIN_RUN) {
+            flushLiterals(i);
+            out.push_back(static_cast<uint8_t>(run + 125));
+            out.push_back(packed[i]);
+            i += run;
+            literalStart = i;
+        } else {
+            i += run;
+        }
+    }
+    flushLiterals(packed.size());
+}
+
+bool decodeChunkTiles(const uint8_t* data, size_t size, uint8_t* tiles, size_t tileCount) {
+    if (size < 1) {
+        return false;
+    }
+    size_t paletteSize = static_cast<size_t>(data[0]) + 1;
+    if (size < 1 + paletteSize) {
+        return false;
+    }
+    const uint8_t* palette = data + 1;
+    data += 1 + paletteSize;
+    size -= 1 + paletteSize;
+
+    unsigned bits = bitsForPalette(paletteSize);
+    if (bits == 0) {
+        std::memset(tiles, palette[0], tileCount);
+        return size == 0;
+    }
+
+    // Expand the runs into the packed indices
+    thread_local std::vector<uint8_t> packed;
+    packed.resize(packedSize(tileCount, bits));
+    size_t filled = 0;
+    while (filled < packed.size()) {
+        if (size < 2) {
+            return false;
+        }
+        uint8_t control = data[0];
+        if (control < 128) {
+            size_t count = static_cast<size_t>(control) + 1;
+            if (count > size - 1 || count > packed.size() - filled) {
+                return false;
+            }
+            std::memcpy(&packed[filled], data + 1, count);
+            data += 1 + count;
+            size -= 1 + count;
+            filled += count;
+        } else {
+            size_t count = static_cast<size_t>(control) - 125;
+            if (count > packed.size() - filled) {
+                return false;
+            }
+            std::memset(&packed[filled], data[1], count);
+            data += 2;
+            size -= 2;
+            filled += count;
+        }
+    }
+    if (size != 0) {
+        return false;
+    }
+
+    // Unpack and map through the palette; indices past the palette are invalid
+    unsigned perByte = 8 / bits;
+    unsigned mask = (1u << bits) - 1;
+    for (size_t i = 0; i < tileCount; ++i) {
+        unsigned index = (packed[i / perByte] >> ((i % perByte) * bits)) & mask;
+        if (index >= paletteSize) {
+            return false;
+        }
+        tiles[i] = palette[index];
+    }
+    return true;
+}
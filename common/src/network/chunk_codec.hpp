@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Compact encoding of a chunk's tile ids, used by CompressedChunk packets.
+//
+//   palette size - 1    1 byte
+//   palette             the distinct tile ids, in order of first appearance
+//   packed indices      only when the palette has more than one entry
+//
+// Each tile is stored as its palette index in 1, 2, 4 or 8 bits (the
+// smallest width that fits the palette), least significant bits first, so
+// no index straddles a byte. The packed bytes are then run-length coded:
+//
+//   control 0..127      control + 1 literal bytes follow
+//   control 128..255    the next byte repeats control - 125 times (3..130)
+//
+// Uniform chunks cost two bytes; a floor with a few walls is mostly long
+// runs of one packed byte. The layout is byte-oriented so both directions
+// are plain loops over bytes plus memset/memcpy for runs and literals,
+// which the compiler and C library vectorize.
+
+// Append the encoding of tileCount tile ids
+void encodeChunkTiles(const uint8_t* tiles, size_t tileCount, std::vector<uint8_t>& out);
+
+// Decode exactly tileCount tile ids into tiles; false if the data is
+// malformed or doesn't describe tileCount tiles
+bool decodeChunkTiles(const uint8_t* data, size_t size, uint8_t* tiles, size_t tileCount);
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+#include "network/byte_stream.hpp"
+
+// UDP side channel datagrams: [4-byte sequence][packet data].
+// Each sender numbers its datagrams with one increasing counter; receivers
+// keep the newest sequence seen per entity and drop anything older, so a
+// reordered or duplicated update never overwrites a newer one.
+constexpr size_t DATAGRAM_HEADER_SIZE = 4;
+
+// Largest datagram either side sends or accepts
+constexpr size_t MAX_DATAGRAM_SIZE = 1200;
+
+// Wrap-around safe "a is newer than b"
+inline bool isNewerSequence(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) > 0;
+}
+
+// Build a datagram from serialized packet bytes
+inline std::vector<uint8_t> makeDatagram(uint32_t sequence, const uint8_t* packet, size_t size) {
+    std::vector<uint8_t> datagram;
+    ByteWriter writer(datagram, DATAGRAM_HEADER_SIZE + size);
+    writer.write(sequence);
+    writer.writeBytes(packet, size);
+    return datagram;
+}
+
+// Newest sequence seen per entity
+class SequenceFilter {
+public:
+    // True if sequence is newer than anything seen for entityId (and records it)
+    bool accept(uint32_t entityId, uint32_t sequence) {
+        auto result = m_latest.try_emplace(entityId, sequence);
+        if (result.second) {
+            return true;
+        }
+        if (!isNewerSequence(sequence, result.first->second)) {
+            return false;
+        }
+        result.first->second = sequence;
+        return true;
+    }
+
+    void forget(uint32_t entityId) { m_latest.erase(entityId); }
+    void clear() { m_latest.clear(); }
+
+private:
+    std::unordered_map<uint32_t, uint32_t> m_latest;
+};
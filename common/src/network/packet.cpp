@@ -0,0 +1,313 @@
+#include "network/packet.hpp"
+
+// Packet view implementations
+bool PacketView::bindHeader(const uint8_t* data, size_t size, PacketType type, size_t minSize) {
+    if (size < minSize || static_cast<PacketType>(data[0]) != type) {
+        return false;
+    }
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+// Check that a length-prefixed string starting at offset fits in the packet
+static bool stringFits(const uint8_t* data, size_t size, size_t offset) {
+    ByteReader reader(data + offset, size - offset);
+    std::string_view value;
+    return reader.readString(value);
+}
+
+bool ConnectRequestView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<ConnectRequestPacket>()) &&
+           stringFits(data, size, fieldOffset<ConnectRequestPacket, 1>());
+}
+
+bool ConnectAcceptView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<ConnectAcceptPacket>());
+}
+
+bool DisconnectView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<DisconnectPacket>()) &&
+           stringFits(data, size, fieldOffset<DisconnectPacket, 0>());
+}
+
+bool PingView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<PingPacket>());
+}
+
+bool PongView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<PongPacket>());
+}
+
+bool PlayerPositionView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<PlayerPositionPacket>());
+}
+
+bool PlayerAppearanceView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<PlayerAppearancePacket>()) &&
+           stringFits(data, size, fieldOffset<PlayerAppearancePacket, 5>());
+}
+
+bool WorldModificationView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<WorldModificationPacket>());
+}
+
+bool WorldChunkView::bind(const uint8_t* data, size_t size) {
+    if (!bindHeader(data, size, TYPE, minSize<WorldChunkPacket>())) {
+        return false;
+    }
+    
+    ByteReader reader(data + fieldOffset<WorldChunkPacket, 4>(), size - fieldOffset<WorldChunkPacket, 4>());
+    uint32_t length = reader.readUnchecked<uint32_t>();
+    return reader.skip(length);
+}
+
+bool CompressedChunkView::bind(const uint8_t* data, size_t size) {
+    if (!bindHeader(data, size, TYPE, minSize<CompressedChunkPacket>())) {
+        return false;
+    }
+    
+    // The tiles are checked when decoding
+    if (getWidth() <= 0 || getHeight() <= 0 || getWidth() > MAX_CHUNK_SIDE || getHeight() > MAX_CHUNK_SIDE) {
+        return false;
+    }
+    
+    ByteReader reader(data + fieldOffset<CompressedChunkPacket, 4>(), size - fieldOffset<CompressedChunkPacket, 4>());
+    uint32_t length = reader.readUnchecked<uint32_t>();
+    return reader.skip(length);
+}
+
+bool ChunkUnloadView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<ChunkUnloadPacket>());
+}
+
+bool ChunkDeltaView::bind(const uint8_t* data, size_t size) {
+    if (!bindHeader(data, size, TYPE, minSize<ChunkDeltaPacket>())) {
+        return false;
+    }
+    
+    int32_t width = getWidth();
+    int32_t height = getHeight();
+    if (width <= 0 || height <= 0 || width > MAX_CHUNK_SIDE || height > MAX_CHUNK_SIDE) {
+        return false;
+    }
+    
+    // The data must be exactly the bitmap plus one value per set bit
+    ByteReader reader(data + fieldOffset<ChunkDeltaPacket, 4>(), size - fieldOffset<ChunkDeltaPacket, 4>());
+    uint32_t length = reader.readUnchecked<uint32_t>();
+    size_t tileCount = static_cast<size_t>(width) * height;
+    size_t bitmapSize = (tileCount + 7) / 8;
+    const uint8_t* bitmap = nullptr;
+    if (length < bitmapSize || !reader.readBytes(bitmapSize, bitmap)) {
+        return false;
+    }
+    
+    size_t changed = 0;
+    for (size_t i = 0; i < tileCount; ++i) {
+        changed += (bitmap[i >> 3] >> (i & 7)) & 1u;
+    }
+    return changed == length - bitmapSize && reader.skip(changed);
+}
+
+bool RegionEditView::bind(const uint8_t* data, size_t size) {
+    if (!bindHeader(data, size, TYPE, minSize<RegionEditPacket>())) {
+        return false;
+    }
+    
+    // The brush mask is checked against the corners when rasterizing
+    ByteReader reader(data + fieldOffset<RegionEditPacket, 6>(), size - fieldOffset<RegionEditPacket, 6>());
+    uint32_t length = reader.readUnchecked<uint32_t>();
+    return length <= regionMaskSize(MAX_REGION_SIDE, MAX_REGION_SIDE) && reader.skip(length);
+}
+
+bool RegionUpdateView::bind(const uint8_t* data, size_t size) {
+    if (!bindHeader(data, size, TYPE, minSize<RegionUpdatePacket>())) {
+        return false;
+    }
+    
+    int32_t width = getWidth();
+    int32_t height = getHeight();
+    if (width <= 0 || height <= 0 || width > MAX_REGION_SIDE || height > MAX_REGION_SIDE) {
+        return false;
+    }
+    
+    // Either no mask (the whole rectangle) or exactly one bit per tile
+    ByteReader reader(data + fieldOffset<RegionUpdatePacket, 5>(), size - fieldOffset<RegionUpdatePacket, 5>());
+    uint32_t length = reader.readUnchecked<uint32_t>();
+    return (length == 0 || length == regionMaskSize(width, height)) && reader.skip(length);
+}
+
+bool ChatMessageView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<ChatMessagePacket>()) &&
+           stringFits(data, size, fieldOffset<ChatMessagePacket, 1>());
+}
+
+bool PlayerListView::bind(const uint8_t* data, size_t size) {
+    if (!bindHeader(data, size, TYPE, minSize<PlayerListPacket>())) {
+        return false;
+    }
+    
+    // Walk the entries once so forEachPlayer() never reads out of bounds
+    ByteReader reader(data + 1, size - 1);
+    uint16_t playerCount = reader.readUnchecked<uint16_t>();
+    std::string_view name;
+    for (uint16_t i = 0; i < playerCount; ++i) {
+        if (!reader.skip(4) || !reader.readString(name) || !reader.skip(8)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool UdpOfferView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<UdpOfferPacket>());
+}
+
+bool UdpHelloView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<UdpHelloPacket>());
+}
+
+bool EntitySpawnView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<EntitySpawnPacket>()) &&
+           stringFits(data, size, fieldOffset<EntitySpawnPacket, 7>());
+}
+
+bool EntityDespawnView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<EntityDespawnPacket>());
+}
+
+bool SnapshotView::bind(const uint8_t* data, size_t size) {
+    if (!bindHeader(data, size, TYPE, minSize<SnapshotPacket>())) {
+        return false;
+    }
+    
+    ByteReader reader(data + fieldOffset<SnapshotPacket, 2>(), size - fieldOffset<SnapshotPacket, 2>());
+    uint32_t length = reader.readUnchecked<uint32_t>();
+    return reader.skip(length);
+}
+
+bool SnapshotAckView::bind(const uint8_t* data, size_t size) {
+    return bindHeader(data, size, TYPE, minSize<SnapshotAckPacket>());
+}
+
+// ConnectRequestPacket implementation
+ConnectRequestPacket::ConnectRequestPacket(const std::string& playerName, uint32_t capabilities)
+    : m_capabilities(capabilities), m_playerName(playerName) {
+}
+
+// ConnectAcceptPacket implementation
+ConnectAcceptPacket::ConnectAcceptPacket(uint32_t playerId)
+    : m_playerId(playerId) {
+}
+
+// DisconnectPacket implementation
+DisconnectPacket::DisconnectPacket(const std::string& reason)
+    : m_reason(reason) {
+}
+
+// PingPacket implementation
+PingPacket::PingPacket(uint32_t timestamp)
+    : m_timestamp(timestamp) {
+}
+
+// PongPacket implementation
+PongPacket::PongPacket(uint32_t timestamp)
+    : m_timestamp(timestamp) {
+}
+
+// PlayerPositionPacket implementation
+PlayerPositionPacket::PlayerPositionPacket(uint32_t playerId, int32_t x, int32_t y)
+    : m_playerId(playerId), m_x(x), m_y(y) {
+}
+
+// PlayerAppearancePacket implementation
+PlayerAppearancePacket::PlayerAppearancePacket(uint32_t playerId, char symbol, 
+                                     uint8_t colorR, uint8_t colorG, uint8_t colorB,
+                                     const std::string& name)
+    : m_playerId(playerId), m_symbol(symbol), 
+      m_colorR(colorR), m_colorG(colorG), m_colorB(colorB),
+      m_name(name) {
+}
+
+// WorldModificationPacket implementation
+WorldModificationPacket::WorldModificationPacket(int32_t x, int32_t y, uint8_t tileType)
+    : m_x(x), m_y(y), m_tileType(tileType) {
+}
+
+// WorldChunkPacket implementation
+WorldChunkPacket::WorldChunkPacket(int32_t x, int32_t y, int32_t width, int32_t height)
+    : m_x(x), m_y(y), m_width(width), m_height(height) {
+}
+
+// ChatMessagePacket implementation
+ChatMessagePacket::ChatMessagePacket(uint32_t playerId, const std::string& message)
+    : m_playerId(playerId), m_message(message) {
+}
+
+// PlayerListPacket implementation
+void PlayerListPacket::addPlayer(uint32_t id, const std::string& name, int32_t x, int32_t y) {
+    PlayerInfo info;
+    info.id = id;
+    info.name = name;
+    info.x = x;
+    info.y = y;
+    m_players.push_back(info);
+}
+
+// UdpOfferPacket implementation
+UdpOfferPacket::UdpOfferPacket(uint16_t port, uint32_t token)
+    : m_port(port), m_token(token) {
+}
+
+// UdpHelloPacket implementation
+UdpHelloPacket::UdpHelloPacket(uint32_t token)
+    : m_token(token) {
+}
+
+// EntitySpawnPacket implementation
+EntitySpawnPacket::EntitySpawnPacket(uint32_t entityId, int32_t x, int32_t y, char symbol,
+                                     uint8_t colorR, uint8_t colorG, uint8_t colorB,
+                                     const std::string& name)
+    : m_entityId(entityId), m_x(x), m_y(y), m_symbol(symbol),
+      m_colorR(colorR), m_colorG(colorG), m_colorB(colorB), m_name(name) {
+}
+
+// EntityDespawnPacket implementation
+EntityDespawnPacket::EntityDespawnPacket(uint32_t entityId)
+    : m_entityId(entityId) {
+}
+
+// SnapshotPacket implementation
+SnapshotPacket::SnapshotPacket(uint32_t tick, uint32_t baselineTick)
+    : m_tick(tick), m_baselineTick(baselineTick) {
+}
+
+// SnapshotAckPacket implementation
+SnapshotAckPacket::SnapshotAckPacket(uint32_t tick)
+    : m_tick(tick) {
+}
+
+// ChunkUnloadPacket implementation
+ChunkUnloadPacket::ChunkUnloadPacket(int32_t x, int32_t y, int32_t width, int32_t height)
+    : m_x(x), m_y(y), m_width(width), m_height(height) {
+}
+
+// ChunkDeltaPacket implementation
+ChunkDeltaPacket::ChunkDeltaPacket(int32_t x, int32_t y, int32_t width, int32_t height)
+    : m_x(x), m_y(y), m_width(width), m_height(height) {
+}
+
+// RegionEditPacket implementation
+RegionEditPacket::RegionEditPacket(RegionShape shape, int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint8_t tileType)
+    : m_shape(static_cast<uint8_t>(shape)), m_x0(x0), m_y0(y0), m_x1(x1), m_y1(y1), m_tileType(tileType) {
+}
+
+// RegionUpdatePacket implementation
+RegionUpdatePacket::RegionUpdatePacket(int32_t x, int32_t y, int32_t width, int32_t height, uint8_t tileType)
+    : m_x(x), m_y(y), m_width(width), m_height(height), m_tileType(tileType) {
+}
+
+// CompressedChunkPacket implementation
+CompressedChunkPacket::CompressedChunkPacket(int32_t x, int32_t y, int32_t width, int32_t height)
+    : m_x(x), m_y(y), m_width(width), m_height(height) {
+}
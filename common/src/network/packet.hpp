@@ -0,0 +1,869 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <tuple>
+#include "network/packet_codec.hpp"
+#include "network/region_edit.hpp"
+
+// Packet types enum
+enum class PacketType : uint8_t {
+    CONNECT_REQUEST = 1,
+    CONNECT_ACCEPT,
+    DISCONNECT,
+    PING,
+    PONG,
+    PLAYER_POSITION,
+    PLAYER_APPEARANCE,
+    WORLD_CHUNK,
+    WORLD_MODIFICATION,
+    CHAT_MESSAGE,
+    PLAYER_LIST,
+    UDP_OFFER,
+    UDP_HELLO,
+    ENTITY_SPAWN,
+    ENTITY_DESPAWN,
+    SNAPSHOT,
+    SNAPSHOT_ACK,
+    CHUNK_UNLOAD,
+    CHUNK_DELTA,
+    REGION_EDIT,
+    REGION_UPDATE,
+    COMPRESSED_CHUNK
+};
+
+// Number of slots needed for a table indexed by PacketType
+constexpr size_t PACKET_TYPE_COUNT = static_cast<size_t>(PacketType::COMPRESSED_CHUNK) + 1;
+
+// Chunks are small; a larger chunk rectangle is malformed
+constexpr int32_t MAX_CHUNK_SIDE = 1024;
+
+// Optional features a client announces in its ConnectRequest; the server
+// only uses the ones both sides support
+enum ClientCapability : uint32_t {
+    CAPABILITY_COMPRESSED_CHUNKS = 1u << 0  // Accepts CompressedChunk instead of WorldChunk
+};
+
+class Packet {
+public:
+    virtual ~Packet() = default;
+    
+    // Serialize packet data to buffer
+    virtual void serialize(std::vector<uint8_t>& buffer) const = 0;
+    
+    // Exact number of bytes serialize() appends
+    virtual size_t serializedSize() const = 0;
+    
+    // Get packet type
+    virtual PacketType getType() const = 0;
+};
+
+// Packet whose wire format is generated from its fields() schema
+template<typename Derived, PacketType Type>
+class SchemaPacket : public Packet {
+public:
+    static constexpr PacketType TYPE = Type;
+    
+    void serialize(std::vector<uint8_t>& buffer) const override {
+        codec::encode(derived(), static_cast<uint8_t>(Type), buffer);
+    }
+    
+    size_t serializedSize() const override {
+        return codec::encodedSize(derived());
+    }
+    
+    PacketType getType() const override { return Type; }
+    
+private:
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+// Connection request packet
+class ConnectRequestPacket : public SchemaPacket<ConnectRequestPacket, PacketType::CONNECT_REQUEST> {
+public:
+    ConnectRequestPacket(const std::string& playerName = "", uint32_t capabilities = 0);
+    
+    const std::string& getPlayerName() const { return m_playerName; }
+    uint32_t getCapabilities() const { return m_capabilities; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_capabilities, m_playerName); }
+    
+private:
+    uint32_t m_capabilities;
+    std::string m_playerName;
+};
+
+// Connection accept packet
+class ConnectAcceptPacket : public SchemaPacket<ConnectAcceptPacket, PacketType::CONNECT_ACCEPT> {
+public:
+    ConnectAcceptPacket(uint32_t playerId = 0);
+    
+    uint32_t getPlayerId() const { return m_playerId; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_playerId); }
+    
+private:
+    uint32_t m_playerId;
+};
+
+// Disconnect packet
+class DisconnectPacket : public SchemaPacket<DisconnectPacket, PacketType::DISCONNECT> {
+public:
+    DisconnectPacket(const std::string& reason = "");
+    
+    const std::string& getReason() const { return m_reason; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_reason); }
+    
+private:
+    std::string m_reason;
+};
+
+// Ping packet
+class PingPacket : public SchemaPacket<PingPacket, PacketType::PING> {
+public:
+    PingPacket(uint32_t timestamp = 0);
+    
+    uint32_t getTimestamp() const { return m_timestamp; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_timestamp); }
+    
+private:
+    uint32_t m_timestamp;
+};
+
+// Pong packet
+class PongPacket : public SchemaPacket<PongPacket, PacketType::PONG> {
+public:
+    PongPacket(uint32_t timestamp = 0);
+    
+    uint32_t getTimestamp() const { return m_timestamp; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_timestamp); }
+    
+private:
+    uint32_t m_timestamp;
+};
+
+// Player position packet
+class PlayerPositionPacket : public SchemaPacket<PlayerPositionPacket, PacketType::PLAYER_POSITION> {
+public:
+    PlayerPositionPacket(uint32_t playerId = 0, int32_t x = 0, int32_t y = 0);
+    
+    uint32_t getPlayerId() const { return m_playerId; }
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_playerId, m_x, m_y); }
+    
+private:
+    uint32_t m_playerId;
+    int32_t m_x;
+    int32_t m_y;
+};
+
+// Player appearance packet
+class PlayerAppearancePacket : public SchemaPacket<PlayerAppearancePacket, PacketType::PLAYER_APPEARANCE> {
+public:
+    PlayerAppearancePacket(uint32_t playerId = 0, char symbol = '@', 
+                          uint8_t colorR = 255, uint8_t colorG = 255, uint8_t colorB = 255,
+                          const std::string& name = "");
+    
+    uint32_t getPlayerId() const { return m_playerId; }
+    char getSymbol() const { return m_symbol; }
+    uint8_t getColorR() const { return m_colorR; }
+    uint8_t getColorG() const { return m_colorG; }
+    uint8_t getColorB() const { return m_colorB; }
+    const std::string& getName() const { return m_name; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_playerId, m_symbol, m_colorR, m_colorG, m_colorB, m_name); }
+    
+private:
+    uint32_t m_playerId;
+    char m_symbol;
+    uint8_t m_colorR;
+    uint8_t m_colorG;
+    uint8_t m_colorB;
+    std::string m_name;
+};
+
+// World modification packet
+class WorldModificationPacket : public SchemaPacket<WorldModificationPacket, PacketType::WORLD_MODIFICATION> {
+public:
+    WorldModificationPacket(int32_t x = 0, int32_t y = 0, uint8_t tileType = 0);
+    
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    uint8_t getTileType() const { return m_tileType; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_x, m_y, m_tileType); }
+    
+private:
+    int32_t m_x;
+    int32_t m_y;
+    uint8_t m_tileType;
+};
+
+// World chunk packet
+class WorldChunkPacket : public SchemaPacket<WorldChunkPacket, PacketType::WORLD_CHUNK> {
+public:
+    WorldChunkPacket(int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
+    
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    int32_t getWidth() const { return m_width; }
+    int32_t getHeight() const { return m_height; }
+    
+    const std::vector<uint8_t>& getTileData() const { return m_tileData; }
+    void setTileData(const std::vector<uint8_t>& tileData) { m_tileData = tileData; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_x, m_y, m_width, m_height, m_tileData); }
+    
+private:
+    int32_t m_x;
+    int32_t m_y;
+    int32_t m_width;
+    int32_t m_height;
+    std::vector<uint8_t> m_tileData;
+};
+
+// World chunk whose tiles are in the compact encoding of chunk_codec.hpp;
+// sent instead of WorldChunk to clients with CAPABILITY_COMPRESSED_CHUNKS
+class CompressedChunkPacket : public SchemaPacket<CompressedChunkPacket, PacketType::COMPRESSED_CHUNK> {
+public:
+    CompressedChunkPacket(int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
+    
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    int32_t getWidth() const { return m_width; }
+    int32_t getHeight() const { return m_height; }
+    
+    const std::vector<uint8_t>& getEncodedTiles() const { return m_encodedTiles; }
+    std::vector<uint8_t>& getEncodedTiles() { return m_encodedTiles; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_x, m_y, m_width, m_height, m_encodedTiles); }
+    
+private:
+    int32_t m_x;
+    int32_t m_y;
+    int32_t m_width;
+    int32_t m_height;
+    std::vector<uint8_t> m_encodedTiles;
+};
+
+// Client may forget a chunk it was sent (tile rectangle, like WorldChunk)
+class ChunkUnloadPacket : public SchemaPacket<ChunkUnloadPacket, PacketType::CHUNK_UNLOAD> {
+public:
+    ChunkUnloadPacket(int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
+    
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    int32_t getWidth() const { return m_width; }
+    int32_t getHeight() const { return m_height; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_x, m_y, m_width, m_height); }
+    
+private:
+    int32_t m_x;
+    int32_t m_y;
+    int32_t m_width;
+    int32_t m_height;
+};
+
+// Tiles of one chunk changed during a tick. The delta data is a bitmap with
+// one bit per tile (row-major, least significant bit first) followed by the
+// new tile type of every set bit, in order.
+class ChunkDeltaPacket : public SchemaPacket<ChunkDeltaPacket, PacketType::CHUNK_DELTA> {
+public:
+    ChunkDeltaPacket(int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
+    
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    int32_t getWidth() const { return m_width; }
+    int32_t getHeight() const { return m_height; }
+    
+    const std::vector<uint8_t>& getDeltaData() const { return m_deltaData; }
+    std::vector<uint8_t>& getDeltaData() { return m_deltaData; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_x, m_y, m_width, m_height, m_deltaData); }
+    
+private:
+    int32_t m_x;
+    int32_t m_y;
+    int32_t m_width;
+    int32_t m_height;
+    std::vector<uint8_t> m_deltaData;
+};
+
+// Client request to set every tile of a region (see region_edit.hpp) to one
+// type. The corners are inclusive; the mask is only sent for BRUSH regions.
+class RegionEditPacket : public SchemaPacket<RegionEditPacket, PacketType::REGION_EDIT> {
+public:
+    RegionEditPacket(RegionShape shape = RegionShape::RECT, int32_t x0 = 0, int32_t y0 = 0,
+                     int32_t x1 = 0, int32_t y1 = 0, uint8_t tileType = 0);
+    
+    RegionShape getShape() const { return static_cast<RegionShape>(m_shape); }
+    int32_t getX0() const { return m_x0; }
+    int32_t getY0() const { return m_y0; }
+    int32_t getX1() const { return m_x1; }
+    int32_t getY1() const { return m_y1; }
+    uint8_t getTileType() const { return m_tileType; }
+    
+    const std::vector<uint8_t>& getMask() const { return m_mask; }
+    std::vector<uint8_t>& getMask() { return m_mask; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_shape, m_x0, m_y0, m_x1, m_y1, m_tileType, m_mask); }
+    
+private:
+    uint8_t m_shape;
+    int32_t m_x0;
+    int32_t m_y0;
+    int32_t m_x1;
+    int32_t m_y1;
+    uint8_t m_tileType;
+    std::vector<uint8_t> m_mask;
+};
+
+// Server update for a region edit: the tiles covered by the mask over the
+// rectangle were set to one type. An empty mask covers the whole rectangle.
+class RegionUpdatePacket : public SchemaPacket<RegionUpdatePacket, PacketType::REGION_UPDATE> {
+public:
+    RegionUpdatePacket(int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0, uint8_t tileType = 0);
+    
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    int32_t getWidth() const { return m_width; }
+    int32_t getHeight() const { return m_height; }
+    uint8_t getTileType() const { return m_tileType; }
+    
+    const std::vector<uint8_t>& getMask() const { return m_mask; }
+    std::vector<uint8_t>& getMask() { return m_mask; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_x, m_y, m_width, m_height, m_tileType, m_mask); }
+    
+private:
+    int32_t m_x;
+    int32_t m_y;
+    int32_t m_width;
+    int32_t m_height;
+    uint8_t m_tileType;
+    std::vector<uint8_t> m_mask;
+};
+
+// Chat message packet
+class ChatMessagePacket : public SchemaPacket<ChatMessagePacket, PacketType::CHAT_MESSAGE> {
+public:
+    ChatMessagePacket(uint32_t playerId = 0, const std::string& message = "");
+    
+    uint32_t getPlayerId() const { return m_playerId; }
+    const std::string& getMessage() const { return m_message; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_playerId, m_message); }
+    
+private:
+    uint32_t m_playerId;
+    std::string m_message;
+};
+
+// Player list packet
+class PlayerListPacket : public SchemaPacket<PlayerListPacket, PacketType::PLAYER_LIST> {
+public:
+    struct PlayerInfo {
+        uint32_t id;
+        std::string name;
+        int32_t x;
+        int32_t y;
+        
+        // Wire layout
+        auto fields() const { return std::tie(id, name, x, y); }
+    };
+    
+    PlayerListPacket() = default;
+    
+    const std::vector<PlayerInfo>& getPlayers() const { return m_players; }
+    void addPlayer(uint32_t id, const std::string& name, int32_t x, int32_t y);
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_players); }
+    
+private:
+    std::vector<PlayerInfo> m_players;
+};
+
+// UDP side channel offer (server to client over TCP, after ConnectAccept)
+class UdpOfferPacket : public SchemaPacket<UdpOfferPacket, PacketType::UDP_OFFER> {
+public:
+    UdpOfferPacket(uint16_t port = 0, uint32_t token = 0);
+    
+    uint16_t getPort() const { return m_port; }
+    uint32_t getToken() const { return m_token; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_port, m_token); }
+    
+private:
+    uint16_t m_port;
+    uint32_t m_token;
+};
+
+// UDP side channel handshake (client to server, echoed back as the ack)
+class UdpHelloPacket : public SchemaPacket<UdpHelloPacket, PacketType::UDP_HELLO> {
+public:
+    UdpHelloPacket(uint32_t token = 0);
+    
+    uint32_t getToken() const { return m_token; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_token); }
+    
+private:
+    uint32_t m_token;
+};
+
+// Entity entered the client's view: appearance and position in one message
+class EntitySpawnPacket : public SchemaPacket<EntitySpawnPacket, PacketType::ENTITY_SPAWN> {
+public:
+    EntitySpawnPacket(uint32_t entityId = 0, int32_t x = 0, int32_t y = 0, char symbol = '@',
+                      uint8_t colorR = 255, uint8_t colorG = 255, uint8_t colorB = 255,
+                      const std::string& name = "");
+    
+    uint32_t getEntityId() const { return m_entityId; }
+    int32_t getX() const { return m_x; }
+    int32_t getY() const { return m_y; }
+    char getSymbol() const { return m_symbol; }
+    uint8_t getColorR() const { return m_colorR; }
+    uint8_t getColorG() const { return m_colorG; }
+    uint8_t getColorB() const { return m_colorB; }
+    const std::string& getName() const { return m_name; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_entityId, m_x, m_y, m_symbol, m_colorR, m_colorG, m_colorB, m_name); }
+    
+private:
+    uint32_t m_entityId;
+    int32_t m_x;
+    int32_t m_y;
+    char m_symbol;
+    uint8_t m_colorR;
+    uint8_t m_colorG;
+    uint8_t m_colorB;
+    std::string m_name;
+};
+
+// Entity left the client's view (or the world)
+class EntityDespawnPacket : public SchemaPacket<EntityDespawnPacket, PacketType::ENTITY_DESPAWN> {
+public:
+    EntityDespawnPacket(uint32_t entityId = 0);
+    
+    uint32_t getEntityId() const { return m_entityId; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_entityId); }
+    
+private:
+    uint32_t m_entityId;
+};
+
+// Positions of the entities a client sees at one tick, delta-encoded against
+// an acknowledged snapshot (baselineTick 0 means against nothing)
+class SnapshotPacket : public SchemaPacket<SnapshotPacket, PacketType::SNAPSHOT> {
+public:
+    SnapshotPacket(uint32_t tick = 0, uint32_t baselineTick = 0);
+    
+    uint32_t getTick() const { return m_tick; }
+    uint32_t getBaselineTick() const { return m_baselineTick; }
+    
+    const std::vector<uint8_t>& getDeltaData() const { return m_deltaData; }
+    std::vector<uint8_t>& getDeltaData() { return m_deltaData; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_tick, m_baselineTick, m_deltaData); }
+    
+private:
+    uint32_t m_tick;
+    uint32_t m_baselineTick;
+    std::vector<uint8_t> m_deltaData;
+};
+
+// Client received and applied the snapshot for a tick
+class SnapshotAckPacket : public SchemaPacket<SnapshotAckPacket, PacketType::SNAPSHOT_ACK> {
+public:
+    SnapshotAckPacket(uint32_t tick = 0);
+    
+    uint32_t getTick() const { return m_tick; }
+    
+    // Wire layout
+    auto fields() const { return std::tie(m_tick); }
+    
+private:
+    uint32_t m_tick;
+};
+
+// Wire layouts are part of the protocol shared by client and server;
+// any change here is a protocol break
+static_assert(codec::LayoutOf<ConnectAcceptPacket>::FIXED && codec::LayoutOf<ConnectAcceptPacket>::MIN_SIZE == 4,
+              "ConnectAccept layout changed");
+static_assert(codec::LayoutOf<PingPacket>::FIXED && codec::LayoutOf<PingPacket>::MIN_SIZE == 4,
+              "Ping layout changed");
+static_assert(codec::LayoutOf<PongPacket>::FIXED && codec::LayoutOf<PongPacket>::MIN_SIZE == 4,
+              "Pong layout changed");
+static_assert(codec::LayoutOf<PlayerPositionPacket>::FIXED && codec::LayoutOf<PlayerPositionPacket>::MIN_SIZE == 12,
+              "PlayerPosition layout changed");
+static_assert(codec::LayoutOf<WorldModificationPacket>::FIXED && codec::LayoutOf<WorldModificationPacket>::MIN_SIZE == 9,
+              "WorldModification layout changed");
+static_assert(codec::LayoutOf<UdpOfferPacket>::FIXED && codec::LayoutOf<UdpOfferPacket>::MIN_SIZE == 6,
+              "UdpOffer layout changed");
+static_assert(codec::LayoutOf<UdpHelloPacket>::FIXED && codec::LayoutOf<UdpHelloPacket>::MIN_SIZE == 4,
+              "UdpHello layout changed");
+static_assert(codec::LayoutOf<EntityDespawnPacket>::FIXED && codec::LayoutOf<EntityDespawnPacket>::MIN_SIZE == 4,
+              "EntityDespawn layout changed");
+static_assert(codec::LayoutOf<ChunkUnloadPacket>::FIXED && codec::LayoutOf<ChunkUnloadPacket>::MIN_SIZE == 16,
+              "ChunkUnload layout changed");
+static_assert(codec::LayoutOf<ChunkDeltaPacket>::MIN_SIZE == 20, "ChunkDelta layout changed");
+static_assert(codec::LayoutOf<RegionEditPacket>::MIN_SIZE == 22, "RegionEdit layout changed");
+static_assert(codec::LayoutOf<RegionUpdatePacket>::MIN_SIZE == 21, "RegionUpdate layout changed");
+static_assert(codec::LayoutOf<SnapshotPacket>::MIN_SIZE == 12, "Snapshot layout changed");
+static_assert(codec::LayoutOf<SnapshotAckPacket>::FIXED && codec::LayoutOf<SnapshotAckPacket>::MIN_SIZE == 4,
+              "SnapshotAck layout changed");
+static_assert(codec::LayoutOf<EntitySpawnPacket>::MIN_SIZE == 18, "EntitySpawn layout changed");
+static_assert(codec::LayoutOf<PlayerAppearancePacket>::MIN_SIZE == 10, "PlayerAppearance layout changed");
+static_assert(codec::LayoutOf<WorldChunkPacket>::MIN_SIZE == 20, "WorldChunk layout changed");
+static_assert(codec::LayoutOf<CompressedChunkPacket>::MIN_SIZE == 20, "CompressedChunk layout changed");
+static_assert(codec::LayoutOf<ConnectRequestPacket>::MIN_SIZE == 6, "ConnectRequest layout changed");
+static_assert(codec::LayoutOf<PlayerListPacket::PlayerInfo>::MIN_SIZE == 14, "PlayerList entry layout changed");
+
+// Non-owning views over a received packet (type byte included).
+// bind() validates the whole packet once; the getters then decode fields
+// straight from the receive buffer without allocating. Field offsets come
+// from the packet schemas above. A view is only valid while the buffer it
+// was bound to is.
+class PacketView {
+public:
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    
+protected:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    
+    // Offset of field I of PacketT, counting the type byte
+    template<typename PacketT, size_t I>
+    static constexpr size_t fieldOffset() { return 1 + codec::LayoutOf<PacketT>::template offset<I>(); }
+    
+    // Smallest valid encoding of PacketT, counting the type byte
+    template<typename PacketT>
+    static constexpr size_t minSize() { return 1 + codec::LayoutOf<PacketT>::MIN_SIZE; }
+    
+    // Decode field I of PacketT
+    template<typename PacketT, size_t I, typename T>
+    T field() const { return codec::load<T>(m_data + fieldOffset<PacketT, I>()); }
+    
+    template<typename PacketT, size_t I>
+    std::string_view stringField() const {
+        const uint8_t* at = m_data + fieldOffset<PacketT, I>();
+        return std::string_view(reinterpret_cast<const char*>(at + 2), codec::load<uint16_t>(at));
+    }
+    
+    // Check the type byte and the minimum size, then take the buffer
+    bool bindHeader(const uint8_t* data, size_t size, PacketType type, size_t minSize);
+};
+
+class ConnectRequestView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::CONNECT_REQUEST;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getCapabilities() const { return field<ConnectRequestPacket, 0, uint32_t>(); }
+    std::string_view getPlayerName() const { return stringField<ConnectRequestPacket, 1>(); }
+};
+
+class ConnectAcceptView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::CONNECT_ACCEPT;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getPlayerId() const { return field<ConnectAcceptPacket, 0, uint32_t>(); }
+};
+
+class DisconnectView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::DISCONNECT;
+    bool bind(const uint8_t* data, size_t size);
+    
+    std::string_view getReason() const { return stringField<DisconnectPacket, 0>(); }
+};
+
+class PingView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::PING;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getTimestamp() const { return field<PingPacket, 0, uint32_t>(); }
+};
+
+class PongView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::PONG;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getTimestamp() const { return field<PongPacket, 0, uint32_t>(); }
+};
+
+class PlayerPositionView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::PLAYER_POSITION;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getPlayerId() const { return field<PlayerPositionPacket, 0, uint32_t>(); }
+    int32_t getX() const { return field<PlayerPositionPacket, 1, int32_t>(); }
+    int32_t getY() const { return field<PlayerPositionPacket, 2, int32_t>(); }
+};
+
+class PlayerAppearanceView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::PLAYER_APPEARANCE;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getPlayerId() const { return field<PlayerAppearancePacket, 0, uint32_t>(); }
+    char getSymbol() const { return field<PlayerAppearancePacket, 1, char>(); }
+    uint8_t getColorR() const { return field<PlayerAppearancePacket, 2, uint8_t>(); }
+    uint8_t getColorG() const { return field<PlayerAppearancePacket, 3, uint8_t>(); }
+    uint8_t getColorB() const { return field<PlayerAppearancePacket, 4, uint8_t>(); }
+    std::string_view getName() const { return stringField<PlayerAppearancePacket, 5>(); }
+};
+
+class WorldModificationView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::WORLD_MODIFICATION;
+    bool bind(const uint8_t* data, size_t size);
+    
+    int32_t getX() const { return field<WorldModificationPacket, 0, int32_t>(); }
+    int32_t getY() const { return field<WorldModificationPacket, 1, int32_t>(); }
+    uint8_t getTileType() const { return field<WorldModificationPacket, 2, uint8_t>(); }
+};
+
+class WorldChunkView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::WORLD_CHUNK;
+    bool bind(const uint8_t* data, size_t size);
+    
+    int32_t getX() const { return field<WorldChunkPacket, 0, int32_t>(); }
+    int32_t getY() const { return field<WorldChunkPacket, 1, int32_t>(); }
+    int32_t getWidth() const { return field<WorldChunkPacket, 2, int32_t>(); }
+    int32_t getHeight() const { return field<WorldChunkPacket, 3, int32_t>(); }
+    
+    const uint8_t* getTileData() const { return m_data + fieldOffset<WorldChunkPacket, 4>() + 4; }
+    uint32_t getTileDataSize() const { return field<WorldChunkPacket, 4, uint32_t>(); }
+};
+
+class CompressedChunkView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::COMPRESSED_CHUNK;
+    bool bind(const uint8_t* data, size_t size);
+    
+    int32_t getX() const { return field<CompressedChunkPacket, 0, int32_t>(); }
+    int32_t getY() const { return field<CompressedChunkPacket, 1, int32_t>(); }
+    int32_t getWidth() const { return field<CompressedChunkPacket, 2, int32_t>(); }
+    int32_t getHeight() const { return field<CompressedChunkPacket, 3, int32_t>(); }
+    
+    const uint8_t* getEncodedTiles() const { return m_data + fieldOffset<CompressedChunkPacket, 4>() + 4; }
+    uint32_t getEncodedTilesSize() const { return field<CompressedChunkPacket, 4, uint32_t>(); }
+};
+
+class ChunkUnloadView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::CHUNK_UNLOAD;
+    bool bind(const uint8_t* data, size_t size);
+    
+    int32_t getX() const { return field<ChunkUnloadPacket, 0, int32_t>(); }
+    int32_t getY() const { return field<ChunkUnloadPacket, 1, int32_t>(); }
+    int32_t getWidth() const { return field<ChunkUnloadPacket, 2, int32_t>(); }
+    int32_t getHeight() const { return field<ChunkUnloadPacket, 3, int32_t>(); }
+};
+
+class ChunkDeltaView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::CHUNK_DELTA;
+    bool bind(const uint8_t* data, size_t size);
+    
+    int32_t getX() const { return field<ChunkDeltaPacket, 0, int32_t>(); }
+    int32_t getY() const { return field<ChunkDeltaPacket, 1, int32_t>(); }
+    int32_t getWidth() const { return field<ChunkDeltaPacket, 2, int32_t>(); }
+    int32_t getHeight() const { return field<ChunkDeltaPacket, 3, int32_t>(); }
+    
+    // Call fn(x, y, tileType) for every changed tile, in world coordinates
+    template<typename Fn>
+    void forEachChange(Fn&& fn) const;
+    
+private:
+    const uint8_t* getDeltaData() const { return m_data + fieldOffset<ChunkDeltaPacket, 4>() + 4; }
+};
+
+class RegionEditView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::REGION_EDIT;
+    bool bind(const uint8_t* data, size_t size);
+    
+    RegionShape getShape() const { return static_cast<RegionShape>(field<RegionEditPacket, 0, uint8_t>()); }
+    int32_t getX0() const { return field<RegionEditPacket, 1, int32_t>(); }
+    int32_t getY0() const { return field<RegionEditPacket, 2, int32_t>(); }
+    int32_t getX1() const { return field<RegionEditPacket, 3, int32_t>(); }
+    int32_t getY1() const { return field<RegionEditPacket, 4, int32_t>(); }
+    uint8_t getTileType() const { return field<RegionEditPacket, 5, uint8_t>(); }
+    const uint8_t* getMask() const { return m_data + fieldOffset<RegionEditPacket, 6>() + 4; }
+    uint32_t getMaskSize() const { return field<RegionEditPacket, 6, uint32_t>(); }
+    
+    // Rasterize the region; false if it is malformed
+    bool rasterize(RegionMask& out) const {
+        return rasterizeRegion(getShape(), getX0(), getY0(), getX1(), getY1(), getMask(), getMaskSize(), out);
+    }
+};
+
+class RegionUpdateView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::REGION_UPDATE;
+    bool bind(const uint8_t* data, size_t size);
+    
+    int32_t getX() const { return field<RegionUpdatePacket, 0, int32_t>(); }
+    int32_t getY() const { return field<RegionUpdatePacket, 1, int32_t>(); }
+    int32_t getWidth() const { return field<RegionUpdatePacket, 2, int32_t>(); }
+    int32_t getHeight() const { return field<RegionUpdatePacket, 3, int32_t>(); }
+    uint8_t getTileType() const { return field<RegionUpdatePacket, 4, uint8_t>(); }
+    
+    // Bitmap over the rectangle, or null when every tile is covered
+    const uint8_t* getMask() const {
+        return field<RegionUpdatePacket, 5, uint32_t>() != 0 ? m_data + fieldOffset<RegionUpdatePacket, 5>() + 4 : nullptr;
+    }
+};
+
+class ChatMessageView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::CHAT_MESSAGE;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getPlayerId() const { return field<ChatMessagePacket, 0, uint32_t>(); }
+    std::string_view getMessage() const { return stringField<ChatMessagePacket, 1>(); }
+};
+
+class PlayerListView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::PLAYER_LIST;
+    bool bind(const uint8_t* data, size_t size);
+    
+    struct PlayerInfo {
+        uint32_t id;
+        std::string_view name;
+        int32_t x;
+        int32_t y;
+    };
+    
+    uint16_t getPlayerCount() const { return codec::load<uint16_t>(m_data + 1); }
+    
+    // Visit every entry in order
+    template<typename Visitor>
+    void forEachPlayer(Visitor&& visitor) const {
+        const uint8_t* cursor = m_data + 3;
+        for (uint16_t i = 0; i < getPlayerCount(); ++i) {
+            PlayerInfo info;
+            info.id = codec::load<uint32_t>(cursor);
+            info.name = std::string_view(reinterpret_cast<const char*>(cursor + 6), codec::load<uint16_t>(cursor + 4));
+            cursor += 6 + info.name.size();
+            info.x = codec::load<int32_t>(cursor);
+            info.y = codec::load<int32_t>(cursor + 4);
+            cursor += 8;
+            visitor(info);
+        }
+    }
+};
+
+class UdpOfferView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::UDP_OFFER;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint16_t getPort() const { return field<UdpOfferPacket, 0, uint16_t>(); }
+    uint32_t getToken() const { return field<UdpOfferPacket, 1, uint32_t>(); }
+};
+
+class UdpHelloView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::UDP_HELLO;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getToken() const { return field<UdpHelloPacket, 0, uint32_t>(); }
+};
+
+class EntitySpawnView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::ENTITY_SPAWN;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getEntityId() const { return field<EntitySpawnPacket, 0, uint32_t>(); }
+    int32_t getX() const { return field<EntitySpawnPacket, 1, int32_t>(); }
+    int32_t getY() const { return field<EntitySpawnPacket, 2, int32_t>(); }
+    char getSymbol() const { return field<EntitySpawnPacket, 3, char>(); }
+    uint8_t getColorR() const { return field<EntitySpawnPacket, 4, uint8_t>(); }
+    uint8_t getColorG() const { return field<EntitySpawnPacket, 5, uint8_t>(); }
+    uint8_t getColorB() const { return field<EntitySpawnPacket, 6, uint8_t>(); }
+    std::string_view getName() const { return stringField<EntitySpawnPacket, 7>(); }
+};
+
+class EntityDespawnView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::ENTITY_DESPAWN;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getEntityId() const { return field<EntityDespawnPacket, 0, uint32_t>(); }
+};
+
+class SnapshotView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::SNAPSHOT;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getTick() const { return field<SnapshotPacket, 0, uint32_t>(); }
+    uint32_t getBaselineTick() const { return field<SnapshotPacket, 1, uint32_t>(); }
+    
+    const uint8_t* getDeltaData() const { return m_data + fieldOffset<SnapshotPacket, 2>() + 4; }
+    uint32_t getDeltaDataSize() const { return field<SnapshotPacket, 2, uint32_t>(); }
+};
+
+class SnapshotAckView : public PacketView {
+public:
+    static constexpr PacketType TYPE = PacketType::SNAPSHOT_ACK;
+    bool bind(const uint8_t* data, size_t size);
+    
+    uint32_t getTick() const { return field<SnapshotAckPacket, 0, uint32_t>(); }
+};
+
+template<typename Fn>
+void ChunkDeltaView::forEachChange(Fn&& fn) const {
+    // bind() checked the bitmap and one value per set bit are present
+    int32_t width = getWidth();
+    int32_t height = getHeight();
+    const uint8_t* bitmap = getDeltaData();
+    const uint8_t* value = bitmap + (static_cast<size_t>(width) * height + 7) / 8;
+    size_t tileCount = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < tileCount; ++i) {
+        if (bitmap[i >> 3] & (1u << (i & 7))) {
+            fn(getX() + static_cast<int32_t>(i % width), getY() + static_cast<int32_t>(i / width), *value++);
+        }
+    }
+}
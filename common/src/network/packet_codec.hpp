@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "network/byte_stream.hpp"
+
+// Compile-time packet schemas.
+// A packet describes its wire layout by returning std::tie() of its members
+// from fields(). The codec derives the encoded size, field offsets and the
+// encoder from that list, so layouts are written down exactly once. Inbound
+// packets are read in place through views (packet.hpp), which use the same
+// sizes and offsets.
+//
+// Field encodings (all integers big-endian):
+//   integral types        sizeof(T) bytes
+//   std::string           uint16 length + bytes
+//   std::vector<uint8_t>  uint32 length + bytes
+//   std::vector<Record>   uint16 count + records, where Record has fields()
+namespace codec {
+
+template<typename T, typename = void>
+struct HasFields : std::false_type {};
+
+template<typename T>
+struct HasFields<T, std::void_t<decltype(std::declval<const T&>().fields())>> : std::true_type {};
+
+template<typename T, typename = void>
+struct FieldTraits;
+
+template<typename Tuple>
+struct TupleLayout;
+
+// Layout of a packet or record type
+template<typename T>
+using LayoutOf = TupleLayout<decltype(std::declval<const T&>().fields())>;
+
+// Integral fields
+template<typename T>
+struct FieldTraits<T, std::enable_if_t<std::is_integral<T>::value>> {
+    static constexpr bool FIXED = true;
+    static constexpr size_t MIN_SIZE = sizeof(T);
+
+    static size_t size(const T&) { return sizeof(T); }
+    static bool write(ByteWriter& writer, const T& value) { return writer.write(value); }
+};
+
+// Strings with a 16-bit length prefix
+template<>
+struct FieldTraits<std::string> {
+    static constexpr bool FIXED = false;
+    static constexpr size_t MIN_SIZE = 2;
+
+    static size_t size(const std::string& value) { return 2 + value.size(); }
+    static bool write(ByteWriter& writer, const std::string& value) { return writer.writeString(value); }
+};
+
+// Raw byte blobs with a 32-bit length prefix
+template<>
+struct FieldTraits<std::vector<uint8_t>> {
+    static constexpr bool FIXED = false;
+    static constexpr size_t MIN_SIZE = 4;
+
+    static size_t size(const std::vector<uint8_t>& value) { return 4 + value.size(); }
+    static bool write(ByteWriter& writer, const std::vector<uint8_t>& value) {
+        return writer.write(static_cast<uint32_t>(value.size())) && writer.writeBytes(value.data(), value.size());
+    }
+};
+
+// Lists of records with a 16-bit count prefix
+template<typename Record>
+struct FieldTraits<std::vector<Record>, std::enable_if_t<HasFields<Record>::value>> {
+    static constexpr bool FIXED = false;
+    static constexpr size_t MIN_SIZE = 2;
+
+    static size_t size(const std::vector<Record>& value) {
+        size_t total = 2;
+        for (const auto& record : value) {
+            total += LayoutOf<Record>::size(record.fields());
+        }
+        return total;
+    }
+
+    static bool write(ByteWriter& writer, const std::vector<Record>& value) {
+        if (!writer.write(static_cast<uint16_t>(value.size()))) {
+            return false;
+        }
+        for (const auto& record : value) {
+            if (!LayoutOf<Record>::write(writer, record.fields())) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+template<typename... Fields>
+struct TupleLayout<std::tuple<Fields&...>> {
+    // Bytes every encoding needs (length prefixes count, their payload doesn't)
+    static constexpr size_t MIN_SIZE = (FieldTraits<std::decay_t<Fields>>::MIN_SIZE + ... + 0);
+
+    // True when the encoded size never varies
+    static constexpr bool FIXED = (FieldTraits<std::decay_t<Fields>>::FIXED && ...);
+
+    // True when every field before I has a fixed size
+    template<size_t I>
+    static constexpr bool prefixFixed() {
+        constexpr bool fixed[] = { FieldTraits<std::decay_t<Fields>>::FIXED..., true };
+        for (size_t i = 0; i < I; ++i) {
+            if (!fixed[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Byte offset of field I (not counting the type byte)
+    template<size_t I>
+    static constexpr size_t offset() {
+        static_assert(I < sizeof...(Fields), "Field index out of range");
+        static_assert(prefixFixed<I>(), "Field offset depends on a variable-length field");
+        constexpr size_t sizes[] = { FieldTraits<std::decay_t<Fields>>::MIN_SIZE..., 0 };
+        size_t result = 0;
+        for (size_t i = 0; i < I; ++i) {
+            result += sizes[i];
+        }
+        return result;
+    }
+
+    template<typename Tuple>
+    static size_t size(const Tuple& fields) {
+        if constexpr (FIXED) {
+            return MIN_SIZE;
+        } else {
+            return std::apply([](const auto&... field) {
+                return (FieldTraits<std::decay_t<decltype(field)>>::size(field) + ... + size_t(0));
+            }, fields);
+        }
+    }
+
+    template<typename Tuple>
+    static bool write(ByteWriter& writer, const Tuple& fields) {
+        return std::apply([&writer](const auto&... field) {
+            return (FieldTraits<std::decay_t<decltype(field)>>::write(writer, field) && ...);
+        }, fields);
+    }
+};
+
+// Exact encoded size of a packet, type byte included
+template<typename PacketT>
+size_t encodedSize(const PacketT& packet) {
+    return 1 + LayoutOf<PacketT>::size(packet.fields());
+}
+
+// Append a packet to buffer: one resize, then direct stores
+template<typename PacketT>
+bool encode(const PacketT& packet, uint8_t type, std::vector<uint8_t>& buffer) {
+    ByteWriter writer(buffer, encodedSize(packet));
+    return writer.write(type) && LayoutOf<PacketT>::write(writer, packet.fields()) && writer.complete();
+}
+
+} // namespace codec
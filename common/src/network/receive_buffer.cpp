@@ -0,0 +1,145 @@
+#include "network/receive_buffer.hpp"
+#include <cstring>
+
+// BufferPool implementation
+BufferPool& BufferPool::instance() {
+    // Never destroyed, so connections torn down during exit can still release
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+size_t BufferPool::bucketFor(size_t size) {
+    size_t bucket = 0;
+    size_t bucketSize = MIN_BUCKET_SIZE;
+    while (bucketSize < size && bucket + 1 < BUCKET_COUNT) {
+        bucketSize <<= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+std::vector<uint8_t> BufferPool::acquire(size_t minSize) {
+    size_t bucket = bucketFor(minSize);
+    size_t bucketSize = MIN_BUCKET_SIZE << bucket;
+    
+    // Requests larger than the biggest bucket are not pooled
+    if (bucketSize < minSize) {
+        return std::vector<uint8_t>(minSize);
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& freeList = m_free[bucket];
+        if (!freeList.empty()) {
+            std::vector<uint8_t> buffer = std::move(freeList.back());
+            freeList.pop_back();
+            return buffer;
+        }
+    }
+    
+    return std::vector<uint8_t>(bucketSize);
+}
+
+void BufferPool::release(std::vector<uint8_t>&& buffer) {
+    size_t bucket = bucketFor(buffer.size());
+    
+    // Only exact bucket sizes go back in; anything else is simply freed
+    if (buffer.size() != (MIN_BUCKET_SIZE << bucket)) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& freeList = m_free[bucket];
+    if (freeList.size() < MAX_FREE_PER_BUCKET) {
+        freeList.push_back(std::move(buffer));
+    }
+}
+
+// ReceiveBuffer implementation
+ReceiveBuffer::ReceiveBuffer()
+    : m_storage(BufferPool::instance().acquire(DEFAULT_CAPACITY)),
+      m_readPos(0),
+      m_writePos(0) {
+}
+
+ReceiveBuffer::~ReceiveBuffer() {
+    BufferPool::instance().release(std::move(m_storage));
+}
+
+void ReceiveBuffer::prepare() {
+    // Drained: rewind, and give oversized storage back to the pool
+    if (pending() == 0) {
+        m_readPos = 0;
+        m_writePos = 0;
+        if (m_storage.size() > DEFAULT_CAPACITY) {
+            reallocate(DEFAULT_CAPACITY);
+        }
+        return;
+    }
+    
+    // Make sure the frame at the read cursor fits once it is complete
+    uint32_t frameLength = peekFrameLength();
+    size_t needed = frameLength > 0 ? HEADER_SIZE + frameLength : HEADER_SIZE;
+    if (m_storage.size() < needed) {
+        reallocate(needed);
+        return;
+    }
+    
+    // Move a trailing partial frame to the front when it would not fit in place
+    if (m_readPos + needed > m_storage.size() || writable() == 0) {
+        size_t bytes = pending();
+        std::memmove(m_storage.data(), m_storage.data() + m_readPos, bytes);
+        m_readPos = 0;
+        m_writePos = bytes;
+    }
+}
+
+ReceiveBuffer::FrameStatus ReceiveBuffer::nextFrame(const uint8_t*& data, uint32_t& length) {
+    if (pending() < HEADER_SIZE) {
+        return FrameStatus::INCOMPLETE;
+    }
+    
+    uint32_t frameLength = peekFrameLength();
+    
+    // Sanity check on packet size
+    if (frameLength == 0 || frameLength > MAX_FRAME_SIZE) {
+        return FrameStatus::INVALID;
+    }
+    
+    if (pending() < HEADER_SIZE + frameLength) {
+        return FrameStatus::INCOMPLETE;
+    }
+    
+    data = m_storage.data() + m_readPos + HEADER_SIZE;
+    length = frameLength;
+    m_readPos += HEADER_SIZE + frameLength;
+    return FrameStatus::COMPLETE;
+}
+
+uint32_t ReceiveBuffer::peekFrameLength() const {
+    if (pending() < HEADER_SIZE) {
+        return 0;
+    }
+    
+    const uint8_t* header = m_storage.data() + m_readPos;
+    uint32_t length =
+        (static_cast<uint32_t>(header[0]) << 24) |
+        (static_cast<uint32_t>(header[1]) << 16) |
+        (static_cast<uint32_t>(header[2]) << 8) |
+         static_cast<uint32_t>(header[3]);
+    
+    // Out-of-range lengths are reported by nextFrame(); don't grow for them
+    return length <= MAX_FRAME_SIZE ? length : 0;
+}
+
+void ReceiveBuffer::reallocate(size_t capacity) {
+    std::vector<uint8_t> storage = BufferPool::instance().acquire(capacity);
+    
+    size_t bytes = pending();
+    std::memcpy(storage.data(), m_storage.data() + m_readPos, bytes);
+    
+    BufferPool::instance().release(std::move(m_storage));
+    m_storage = std::move(storage);
+    m_readPos = 0;
+    m_writePos = bytes;
+}
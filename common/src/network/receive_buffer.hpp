@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <mutex>
+
+// Process-wide pool of receive storage, bucketed by power-of-two size.
+// Connections that briefly needed a large buffer hand it back here instead of
+// keeping it for the rest of their lifetime.
+class BufferPool {
+public:
+    static BufferPool& instance();
+    
+    // Get a buffer whose size() is at least minSize
+    std::vector<uint8_t> acquire(size_t minSize);
+    
+    // Return a buffer obtained from acquire()
+    void release(std::vector<uint8_t>&& buffer);
+    
+private:
+    BufferPool() = default;
+    
+    // Buckets hold 4 KB << index, up to 4 MB
+    static constexpr size_t MIN_BUCKET_SIZE = 4 * 1024;
+    static constexpr size_t BUCKET_COUNT = 11;
+    static constexpr size_t MAX_FREE_PER_BUCKET = 16;
+    
+    static size_t bucketFor(size_t size);
+    
+    std::mutex m_mutex;
+    std::vector<std::vector<uint8_t>> m_free[BUCKET_COUNT];
+};
+
+// Per-connection receive ring for length-prefixed frames.
+// Socket reads append at the write cursor; complete frames are parsed in place
+// from the read cursor. The cursors rewind when the ring drains and a trailing
+// partial frame is moved to the front, so every frame is contiguous in memory.
+class ReceiveBuffer {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16 * 1024;
+    static constexpr uint32_t MAX_FRAME_SIZE = 1024 * 1024;
+    static constexpr size_t HEADER_SIZE = 4;
+    
+    enum class FrameStatus {
+        COMPLETE,    // A frame was returned
+        INCOMPLETE,  // More bytes are needed
+        INVALID      // The length header is out of range
+    };
+    
+    ReceiveBuffer();
+    ~ReceiveBuffer();
+    
+    // Make room for the next read; call before writePtr()/writable()
+    void prepare();
+    
+    // Free space to read into
+    uint8_t* writePtr() { return m_storage.data() + m_writePos; }
+    size_t writable() const { return m_storage.size() - m_writePos; }
+    
+    // Account for bytes written by a read
+    void commit(size_t bytes) { m_writePos += bytes; }
+    
+    // Take the next complete frame body; data stays valid until prepare()
+    FrameStatus nextFrame(const uint8_t*& data, uint32_t& length);
+    
+    // Disable copying
+    ReceiveBuffer(const ReceiveBuffer&) = delete;
+    ReceiveBuffer& operator=(const ReceiveBuffer&) = delete;
+    
+private:
+    std::vector<uint8_t> m_storage;
+    size_t m_readPos;
+    size_t m_writePos;
+    
+    size_t pending() const { return m_writePos - m_readPos; }
+    
+    // Length of the frame at the read cursor, or 0 if the header is incomplete
+    uint32_t peekFrameLength() const;
+    
+    // Move pending bytes into storage of the given capacity
+    void reallocate(size_t capacity);
+};
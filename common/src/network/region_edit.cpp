@@ -0,0 +1,62 @@
+#include "network/region_edit.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+bool rasterizeRegion(RegionShape shape, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                     const uint8_t* brush, size_t brushSize, RegionMask& out) {
+    // Widen before subtracting so far-apart corners can't overflow
+    int64_t width = std::llabs(static_cast<int64_t>(x1) - x0) + 1;
+    int64_t height = std::llabs(static_cast<int64_t>(y1) - y0) + 1;
+    if (width > MAX_REGION_SIDE || height > MAX_REGION_SIDE) {
+        return false;
+    }
+
+    out.x = std::min(x0, x1);
+    out.y = std::min(y0, y1);
+    out.width = static_cast<int32_t>(width);
+    out.height = static_cast<int32_t>(height);
+    out.bits.clear();
+
+    switch (shape) {
+        case RegionShape::RECT:
+            return true;
+
+        case RegionShape::BRUSH:
+            if (!brush || brushSize != regionMaskSize(out.width, out.height)) {
+                return false;
+            }
+            out.bits.assign(brush, brush + brushSize);
+            return true;
+
+        case RegionShape::LINE: {
+            // Bresenham from the first point to the second, so the same
+            // endpoints always give the same tiles
+            out.bits.assign(regionMaskSize(out.width, out.height), 0);
+            int32_t dx = std::abs(x1 - x0);
+            int32_t dy = -std::abs(y1 - y0);
+            int32_t stepX = x0 < x1 ? 1 : -1;
+            int32_t stepY = y0 < y1 ? 1 : -1;
+            int32_t error = dx + dy;
+            int32_t x = x0;
+            int32_t y = y0;
+            while (true) {
+                size_t index = static_cast<size_t>(y - out.y) * out.width + (x - out.x);
+                out.bits[index >> 3] |= static_cast<uint8_t>(1u << (index & 7));
+                if (x == x1 && y == y1) {
+                    break;
+                }
+                int32_t doubled = 2 * error;
+                if (doubled >= dy) {
+                    error += dy;
+                    x += stepX;
+                }
+                if (doubled <= dx) {
+                    error += dx;
+                    y += stepY;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
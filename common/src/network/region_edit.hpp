@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Edits that cover many tiles at once. A client sends the shape; both sides
+// rasterize it the same way into a mask over the shape's bounding rectangle,
+// so the server applies it in one World call and clients receive the result
+// as one region update instead of a packet per tile.
+
+enum class RegionShape : uint8_t {
+    RECT,   // Every tile between the two corners
+    LINE,   // Tiles on the line between the two end points
+    BRUSH   // Tiles whose bit is set in a mask over the corners' rectangle
+};
+
+// Longest side a region may have
+constexpr int32_t MAX_REGION_SIDE = 64;
+
+// Bytes in a bitmap with one bit per tile of a width x height rectangle
+inline size_t regionMaskSize(int32_t width, int32_t height) {
+    return (static_cast<size_t>(width) * height + 7) / 8;
+}
+
+// Tiles covered by a region: its bounding rectangle and, unless every tile
+// in it is covered, a row-major bitmap (least significant bit first)
+struct RegionMask {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    std::vector<uint8_t> bits;
+
+    bool isFull() const { return bits.empty(); }
+    bool covers(size_t index) const { return isFull() || ((bits[index >> 3] >> (index & 7)) & 1u); }
+};
+
+// Rasterize a shape given by two corners (in any order). brush/brushSize is
+// the mask of a BRUSH region and ignored otherwise. Returns false for an
+// unknown shape, a side longer than MAX_REGION_SIDE or a brush mask of the
+// wrong size.
+bool rasterizeRegion(RegionShape shape, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                     const uint8_t* brush, size_t brushSize, RegionMask& out);
@@ -0,0 +1,189 @@
+#include "network/snapshot.hpp"
+#include "network/bit_stream.hpp"
+
+// Delta layout, bit-packed:
+//   count                     entities that changed, were added or removed
+//   per entity, by id:
+//     id                      first id as is, then the gap to the previous id minus one
+//     removed                 1 bit
+//     xChanged [dx]           1 bit, then the zigzag difference from the baseline
+//     yChanged [dy]           1 bit, then the zigzag difference from the baseline
+// Entities missing from the baseline are encoded against (0, 0).
+
+namespace {
+
+// Unsigned values in 5, 14 or 34 bits: small id gaps and one-tile moves
+// take the shortest form
+void writeVarUint(BitWriter& writer, uint32_t value) {
+    if (value < (1u << 4)) {
+        writer.writeBit(false);
+        writer.write(value, 4);
+    } else if (value < (1u << 12)) {
+        writer.write(0x2, 2);
+        writer.write(value, 12);
+    } else {
+        writer.write(0x3, 2);
+        writer.write(value, 32);
+    }
+}
+
+bool readVarUint(BitReader& reader, uint32_t& value) {
+    bool wide = false;
+    if (!reader.readBit(wide)) {
+        return false;
+    }
+    if (!wide) {
+        return reader.read(4, value);
+    }
+    bool widest = false;
+    if (!reader.readBit(widest)) {
+        return false;
+    }
+    return reader.read(widest ? 32 : 12, value);
+}
+
+uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+struct DeltaRecord {
+    uint32_t id;
+    bool removed;
+    int32_t dx;
+    int32_t dy;
+};
+
+// Smallest encoded record: 5-bit id and the removed bit
+constexpr size_t MIN_RECORD_BITS = 6;
+
+} // namespace
+
+size_t encodeSnapshotDelta(const SnapshotState& baseline, const SnapshotState& current,
+                           std::vector<uint8_t>& out) {
+    // Collect the changes first: the count goes in front
+    thread_local std::vector<DeltaRecord> records;
+    records.clear();
+
+    size_t b = 0;
+    size_t c = 0;
+    while (b < baseline.size() || c < current.size()) {
+        if (c == current.size() || (b < baseline.size() && baseline[b].id < current[c].id)) {
+            records.push_back(DeltaRecord{baseline[b].id, true, 0, 0});
+            ++b;
+        } else if (b == baseline.size() || current[c].id < baseline[b].id) {
+            records.push_back(DeltaRecord{current[c].id, false, current[c].x, current[c].y});
+            ++c;
+        } else {
+            int32_t dx = static_cast<int32_t>(static_cast<uint32_t>(current[c].x) - static_cast<uint32_t>(baseline[b].x));
+            int32_t dy = static_cast<int32_t>(static_cast<uint32_t>(current[c].y) - static_cast<uint32_t>(baseline[b].y));
+            if (dx != 0 || dy != 0) {
+                records.push_back(DeltaRecord{current[c].id, false, dx, dy});
+            }
+            ++b;
+            ++c;
+        }
+    }
+
+    if (records.empty()) {
+        return 0;
+    }
+
+    BitWriter writer(out);
+    writeVarUint(writer, static_cast<uint32_t>(records.size()));
+    uint32_t previousId = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        const DeltaRecord& record = records[i];
+        writeVarUint(writer, i == 0 ? record.id : record.id - previousId - 1);
+        previousId = record.id;
+
+        writer.writeBit(record.removed);
+        if (record.removed) {
+            continue;
+        }
+        writer.writeBit(record.dx != 0);
+        if (record.dx != 0) {
+            writeVarUint(writer, zigzag(record.dx));
+        }
+        writer.writeBit(record.dy != 0);
+        if (record.dy != 0) {
+            writeVarUint(writer, zigzag(record.dy));
+        }
+    }
+    writer.flush();
+    return records.size();
+}
+
+bool decodeSnapshotDelta(const SnapshotState& baseline, const uint8_t* data, size_t size,
+                         SnapshotState& out) {
+    out.clear();
+    BitReader reader(data, size);
+
+    uint32_t count = 0;
+    if (!readVarUint(reader, count) || count > reader.remainingBits() / MIN_RECORD_BITS) {
+        return false;
+    }
+
+    size_t b = 0;
+    uint32_t id = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t gap = 0;
+        bool removed = false;
+        if (!readVarUint(reader, gap) || !reader.readBit(removed)) {
+            return false;
+        }
+
+        // Ids are strictly increasing
+        uint32_t nextId = i == 0 ? gap : id + gap + 1;
+        if (i > 0 && nextId <= id) {
+            return false;
+        }
+        id = nextId;
+
+        // Baseline entities before this id are unchanged
+        while (b < baseline.size() && baseline[b].id < id) {
+            out.push_back(baseline[b++]);
+        }
+        bool inBaseline = b < baseline.size() && baseline[b].id == id;
+
+        if (removed) {
+            if (!inBaseline) {
+                return false;
+            }
+            ++b;
+            continue;
+        }
+
+        SnapshotEntity entity = inBaseline ? baseline[b++] : SnapshotEntity{id, 0, 0};
+        bool changed = false;
+        uint32_t value = 0;
+        if (!reader.readBit(changed)) {
+            return false;
+        }
+        if (changed) {
+            if (!readVarUint(reader, value)) {
+                return false;
+            }
+            entity.x = static_cast<int32_t>(static_cast<uint32_t>(entity.x) + static_cast<uint32_t>(unzigzag(value)));
+        }
+        if (!reader.readBit(changed)) {
+            return false;
+        }
+        if (changed) {
+            if (!readVarUint(reader, value)) {
+                return false;
+            }
+            entity.y = static_cast<int32_t>(static_cast<uint32_t>(entity.y) + static_cast<uint32_t>(unzigzag(value)));
+        }
+        out.push_back(entity);
+    }
+
+    // Everything after the last change is unchanged
+    while (b < baseline.size()) {
+        out.push_back(baseline[b++]);
+    }
+    return true;
+}
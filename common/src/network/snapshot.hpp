@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+
+// Tick-numbered snapshots of the entities one client can see.
+// The server sends each snapshot as a delta against the newest snapshot the
+// client acknowledged (its baseline); the client rebuilds the full state from
+// the baseline it kept and acknowledges the result. Entities that didn't
+// change since the baseline cost nothing; changed coordinates are sent as
+// bit-packed differences.
+
+// One replicated entity
+struct SnapshotEntity {
+    uint32_t id;
+    int32_t x;
+    int32_t y;
+
+    bool operator==(const SnapshotEntity& other) const {
+        return id == other.id && x == other.x && y == other.y;
+    }
+};
+
+// All entities in one snapshot, sorted by id
+using SnapshotState = std::vector<SnapshotEntity>;
+
+// Append the delta from baseline to current; returns the number of entities
+// written (0 when current equals baseline)
+size_t encodeSnapshotDelta(const SnapshotState& baseline, const SnapshotState& current,
+                           std::vector<uint8_t>& out);
+
+// Rebuild a state from its baseline and an encoded delta; false if the delta
+// is malformed or doesn't fit the baseline
+bool decodeSnapshotDelta(const SnapshotState& baseline, const uint8_t* data, size_t size,
+                         SnapshotState& out);
+
+// Recently sent (server) or received (client) snapshots by tick.
+// Tick 0 means "no snapshot", so it is never stored.
+class SnapshotHistory {
+public:
+    // A sender may delta against a baseline only while it is less than
+    // CAPACITY ticks older than the newest snapshot sent; the receiver's
+    // history then still holds it too
+    static constexpr uint32_t CAPACITY = 64;
+
+    void store(uint32_t tick, const SnapshotState& state) {
+        if (tick == 0) {
+            return;
+        }
+        Slot& slot = m_slots[tick % CAPACITY];
+        slot.tick = tick;
+        slot.state.assign(state.begin(), state.end());
+    }
+
+    const SnapshotState* find(uint32_t tick) const {
+        const Slot& slot = m_slots[tick % CAPACITY];
+        return tick != 0 && slot.tick == tick ? &slot.state : nullptr;
+    }
+
+    void clear() {
+        for (Slot& slot : m_slots) {
+            slot.tick = 0;
+            slot.state.clear();
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t tick = 0;
+        SnapshotState state;
+    };
+    std::array<Slot, CAPACITY> m_slots;
+};